@@ -17,8 +17,12 @@
 #include <Pothos/Framework/PortInfo.hpp>
 #include <Pothos/Framework/InputPort.hpp>
 #include <Pothos/Framework/OutputPort.hpp>
+#include <Pothos/Framework/ThreadPool.hpp>
 #include <Pothos/Framework/Block.hpp>
 #include <Pothos/Framework/Topology.hpp>
+#include <Pothos/Framework/TopologyStats.hpp>
+#include <Pothos/Framework/Trace.hpp>
+#include <Pothos/Framework/MetricsServer.hpp>
 #include <Pothos/Framework/TopologyImpl.hpp>
 #include <Pothos/Framework/BlockRegistry.hpp>
 #include <Pothos/Framework/BufferManager.hpp>
@@ -15,6 +15,7 @@
 #include <Pothos/Framework/PortInfo.hpp>
 #include <Pothos/Framework/InputPort.hpp>
 #include <Pothos/Framework/OutputPort.hpp>
+#include <Pothos/Framework/ThreadPool.hpp>
 #include <memory>
 #include <string>
 #include <vector>
@@ -197,7 +198,24 @@ public:
      */
     void registerCallable(const std::string &name, const Callable &call);
 
+    /*!
+     * Set the thread pool used to execute this block.
+     * Blocks are assigned the default thread pool at construction.
+     * The thread pool can only be changed while the block is not
+     * active and none of its ports are connected to other blocks.
+     * Output buffers are allocated on the thread pool's NUMA node.
+     * \throws ThreadPoolError if the thread pool cannot be changed
+     * \param threadPool the new thread pool for this block
+     */
+    void setThreadPool(const ThreadPool &threadPool);
+
+    /*!
+     * Get the thread pool used to execute this block.
+     */
+    const ThreadPool &getThreadPool(void) const;
+
 private:
+    ThreadPool _threadPool;
     std::shared_ptr<Theron::Framework> _framework;
 public:
     std::shared_ptr<WorkerActor> _actor;
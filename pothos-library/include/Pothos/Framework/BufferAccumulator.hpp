@@ -71,6 +71,12 @@ public:
      */
     void require(const size_t numBytes);
 
+    //! Get the number of require() calls that reused a pooled buffer
+    unsigned long long getPoolHits(void) const;
+
+    //! Get the number of require() calls that allocated a new buffer
+    unsigned long long getPoolMisses(void) const;
+
 private:
     Util::RingDeque<BufferChunk> _queue;
     size_t _bytesAvailable;
@@ -99,6 +99,14 @@ public:
      */
     bool null(void) const;
 
+    /*!
+     * Is this the only reference to the underlying memory?
+     * A managed buffer is unique when no other chunk holds it;
+     * otherwise the shared buffer's reference count is used.
+     * \return true if this is the only copy
+     */
+    bool unique(void) const;
+
 private:
     SharedBuffer _buffer;
     ManagedBuffer _managedBuffer;
@@ -138,3 +146,9 @@ inline bool Pothos::BufferChunk::null(void) const
 {
     return (address == 0) and _buffer.null() and _managedBuffer.null();
 }
+
+inline bool Pothos::BufferChunk::unique(void) const
+{
+    if (not _managedBuffer.null()) return _managedBuffer.unique();
+    return _buffer.unique();
+}
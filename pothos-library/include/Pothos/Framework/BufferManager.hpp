@@ -10,9 +10,13 @@
 #pragma once
 #include <Pothos/Config.hpp>
 #include <Pothos/Framework/ManagedBuffer.hpp>
+#include <Pothos/Util/MPSCQueue.hpp>
 #include <memory> //shared_ptr
 #include <string>
 #include <functional>
+#include <atomic>
+#include <mutex>
+#include <vector>
 
 namespace Pothos {
 
@@ -44,6 +48,15 @@ struct POTHOS_API BufferManagerArgs
      * Default: -1 or unspecified affinity
      */
     long nodeAffinity;
+
+    /*!
+     * Allocate the buffers for the generic manager from huge pages.
+     * All buffers are carved from one slab that uses SharedBuffer::makeHuge().
+     * This is intended for large stream buffers with many bytes in flight.
+     * This argument is not used for the special-case managers.
+     * Default: false
+     */
+    bool hugePages;
 };
 
 /*!
@@ -57,6 +70,9 @@ public:
 
     typedef std::shared_ptr<BufferManager> Sptr;
 
+    //! Construct an empty buffer manager
+    BufferManager(void);
+
     /*!
      * The BufferManager factory -- makes a new BufferManager given the factory name.
      * Plugins for custom BufferManagers should be located in
@@ -81,6 +97,13 @@ public:
      */
     virtual bool empty(void) const = 0;
 
+    /*!
+     * How many buffers are ready for use?
+     * The default implementation only knows whether the manager is empty.
+     * \return the number of available buffers
+     */
+    virtual size_t numReady(void) const;
+
     /*!
      * Get a reference to the front buffer.
      * front().address will be the start of a valid buffer,
@@ -115,25 +138,75 @@ public:
     virtual void push(const ManagedBuffer &buff) = 0;
 
     /*!
-     * Push external returns a buffer to the manager through a callback.
-     * This call is used to return a buffer from a different thread context.
-     * The callback implements the thread-safe delivery mechanism.
+     * Push external returns a buffer to the manager from any thread context.
+     * When a callback is set, the buffer is placed into a lock-free return queue,
+     * and the owner of the manager moves it into the manager with flushExternal().
+     * The queue is sized for the numBuffers argument; when a manager hands out
+     * more buffers than that, the extra returns go to a locked overflow list.
+     * The callback is only invoked when the owner was starved for buffers.
+     * Without a callback, the buffer is pushed directly into the manager.
      */
     void pushExternal(const ManagedBuffer &buff);
 
+    /*!
+     * Move the buffers in the return queue into the manager.
+     * This call is made from the thread context that owns the manager.
+     * When the manager is still empty, it is marked as starved,
+     * so the next call to pushExternal() will invoke the callback.
+     */
+    void flushExternal(void);
+
     /*!
      * Set the callback for use with the pushExternal API call.
+     * The callback wakes the owner of the manager to call flushExternal().
      */
-    void setCallback(const std::function<void(const ManagedBuffer &)> &callback);
+    void setCallback(const std::function<void(void)> &callback);
 
 private:
-    std::function<void(const ManagedBuffer &)> _callback;
+    std::function<void(void)> _callback;
+    Util::MPSCQueue<ManagedBuffer> _returnQueue;
+    std::atomic<bool> _starved;
+    std::atomic<bool> _hasOverflow;
+    std::mutex _overflowMutex;
+    std::vector<ManagedBuffer> _overflow;
+    void flushReturns(void);
 };
 
 } //namespace Pothos
 
 inline void Pothos::BufferManager::pushExternal(const ManagedBuffer &buff)
 {
-    if (_callback) _callback(buff);
-    else this->push(buff);
+    if (not _callback) return this->push(buff);
+
+    //the owner may be this very thread, so a full queue spills into the overflow
+    if (not _returnQueue.push(buff))
+    {
+        std::lock_guard<std::mutex> lock(_overflowMutex);
+        _overflow.push_back(buff);
+        _hasOverflow = true;
+    }
+
+    //wake the owner once per starvation
+    if (_starved.exchange(false)) _callback();
+}
+
+inline void Pothos::BufferManager::flushReturns(void)
+{
+    ManagedBuffer buff;
+    while (_returnQueue.pop(buff)) this->push(buff);
+    if (not _hasOverflow.exchange(false)) return;
+    std::lock_guard<std::mutex> lock(_overflowMutex);
+    for (const auto &overflow : _overflow) this->push(overflow);
+    _overflow.clear();
+}
+
+inline void Pothos::BufferManager::flushExternal(void)
+{
+    this->flushReturns();
+    if (not this->empty()) return;
+
+    //mark starved before checking again, a buffer that was
+    //pushed before the flag was set is caught by this flush
+    _starved.exchange(true);
+    this->flushReturns();
 }
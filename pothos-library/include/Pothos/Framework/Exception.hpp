@@ -48,4 +48,14 @@ POTHOS_DECLARE_EXCEPTION(POTHOS_API, TopologyConnectError, RuntimeException)
  */
 POTHOS_DECLARE_EXCEPTION(POTHOS_API, BlockCallNotFound, RuntimeException)
 
+/*!
+ * A ThreadPoolError is thrown when a thread pool cannot be created or assigned.
+ */
+POTHOS_DECLARE_EXCEPTION(POTHOS_API, ThreadPoolError, RuntimeException)
+
+/*!
+ * A MetricsServerError is thrown when the metrics server cannot be started.
+ */
+POTHOS_DECLARE_EXCEPTION(POTHOS_API, MetricsServerError, RuntimeException)
+
 } //namespace Pothos
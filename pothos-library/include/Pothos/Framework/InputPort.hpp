@@ -108,12 +108,55 @@ public:
      * Set a reserve requirement on this input port.
      * A reserve requirement means that work() will not be called
      * unless this input port has at least numElements available;
-     * An exception to this rule is when a message is available.
+     * An exception to this rule is when a message is available,
+     * or when all connected inputs ended on a port that opted in
+     * with setFlushAtEnd(), see isEndOfStream().
      * By default, each input port has a reserve of zero elements.
      * \param numElements the number of elements to require
      */
     void setReserve(const size_t numElements);
 
+    /*!
+     * Call work() below the reserve once all connected inputs ended.
+     * This lets a block flush a remainder that will never fill the reserve.
+     * Without it, a remainder below the reserve is dropped at the end,
+     * and the block is done without another call to work().
+     * By default, the remainder is dropped.
+     * \param enabled true to call work() with the remainder
+     */
+    void setFlushAtEnd(const bool enabled);
+
+    /*!
+     * Limit the number of asynchronous messages queued on this port.
+     * When the limit is reached, the BACKPRESSURE policy throttles the
+     * work() of the upstream blocks that post to this port, until
+     * popMessage() drains the queue to half of the limit.
+     * Messages already in flight are still queued, so the queue
+     * can overshoot by the messages from one upstream work() call.
+     * The DROP policy discards new messages beyond the limit,
+     * and counts them in droppedMessages().
+     * By default, the number of queued messages is unlimited.
+     * \throws PortAccessError if the policy is unknown
+     * \param depth the maximum number of messages, or zero for no limit
+     * \param policy "BACKPRESSURE" or "DROP"
+     */
+    void setMessageDepth(const size_t depth, const std::string &policy = "BACKPRESSURE");
+
+    //! Get the number of messages discarded by the DROP policy.
+    unsigned long long droppedMessages(void) const;
+
+    /*!
+     * Did every upstream port post end-of-stream to this port?
+     * Elements and messages that arrived before the end-of-stream
+     * may remain to be consumed; a block can use this to flush them.
+     * Once all connected inputs ended, work() is called with fewer
+     * elements than the reserve only on ports set with setFlushAtEnd(),
+     * and the block is done after a work() call that consumes and
+     * produces nothing, or when only a dropped remainder is left.
+     * \return true when the stream on this port has ended
+     */
+    bool isEndOfStream(void) const;
+
 private:
     InputPortImpl *_impl;
     int _index;
@@ -126,10 +169,12 @@ private:
     LabelIteratorRange _labelIter;
     size_t _pendingElements;
     size_t _reserveElements;
+    bool _flushAtEnd;
     InputPort(InputPortImpl *);
     InputPort(const InputPort &){} // non construction-copyable
     InputPort &operator=(const InputPort &){return *this;} // non copyable
     friend class WorkerActor;
+    friend class OutputPort;
 };
 
 } //namespace Pothos
@@ -183,3 +228,8 @@ inline void Pothos::InputPort::setReserve(const size_t numElements)
 {
     _reserveElements = numElements;
 }
+
+inline void Pothos::InputPort::setFlushAtEnd(const bool enabled)
+{
+    _flushAtEnd = enabled;
+}
@@ -68,6 +68,12 @@ public:
      */
     size_t getSlabIndex(void) const;
 
+    /*!
+     * Is this instance of this managed buffer unique?
+     * \return true if this is the only copy
+     */
+    bool unique(void) const;
+
     //! ManagedBuffer destructor
     ~ManagedBuffer(void);
 
@@ -0,0 +1,55 @@
+//
+// Framework/MetricsServer.hpp
+//
+// HTTP endpoint that serves worker metrics to a Prometheus scraper.
+//
+// Copyright (c) 2014-2014 Josh Blum
+// SPDX-License-Identifier: BSL-1.0
+//
+
+#pragma once
+#include <Pothos/Config.hpp>
+#include <string>
+#include <memory>
+
+namespace Pothos {
+
+/*!
+ * The MetricsServer serves the counters of the blocks in this process
+ * over HTTP in the Prometheus text exposition format at "/metrics".
+ * The metrics cover the block and port counters, the output buffer
+ * pool occupancy, and the input message and label queue depths.
+ * While a server is alive, the workers publish their counters as they run,
+ * so a scrape reads them without messaging any worker.
+ * Without a server, the workers do not publish at all.
+ * The server runs until the MetricsServer object is destroyed.
+ */
+class POTHOS_API MetricsServer
+{
+public:
+
+    /*!
+     * Start serving metrics on a TCP port of all interfaces.
+     * \throws MetricsServerError when the port cannot be bound
+     * \param port the TCP port to bind, or 0 to pick a free port
+     */
+    MetricsServer(const unsigned short port = 0);
+
+    //! Stop serving metrics
+    ~MetricsServer(void);
+
+    //! Get the TCP port that the server is bound to
+    unsigned short getPort(void) const;
+
+    /*!
+     * Get the metrics of all blocks in this process in the Prometheus text format.
+     * The values are only current while a MetricsServer is alive.
+     */
+    static std::string getMetricsText(void);
+
+private:
+    struct Impl;
+    std::shared_ptr<Impl> _impl;
+};
+
+} //namespace Pothos
@@ -13,11 +13,13 @@
 #include <Pothos/Framework/DType.hpp>
 #include <Pothos/Framework/Label.hpp>
 #include <Pothos/Framework/BufferChunk.hpp>
+#include <Pothos/Framework/BufferManager.hpp>
 #include <string>
 
 namespace Pothos {
 
 class OutputPortImpl;
+class InputPort;
 class WorkerActor;
 
 /*!
@@ -90,6 +92,9 @@ public:
 
     /*!
      * Post an output label to the subscribers on this port.
+     * Labels posted from work() or propagateLabels() are sent
+     * together with the stream buffer produced by the same call,
+     * or on their own after work() when nothing was produced.
      * \param label the label to post
      */
     void postLabel(const Label &label);
@@ -111,6 +116,50 @@ public:
      */
     void postBuffer(const BufferChunk &buffer);
 
+    /*!
+     * Post end-of-stream to the subscribers on this port.
+     * End-of-stream tells the subscribers that this port is finished.
+     * When posted from work(), it is sent after the buffers of that call,
+     * so the subscribers receive it after all of the data on this port.
+     * Once every connected input of a downstream block has ended and
+     * its work() had the chance to flush, see InputPort::setFlushAtEnd(),
+     * the framework posts end-of-stream on the outputs of that block,
+     * so it propagates from sources to sinks.
+     * A block with no connected inputs is done once all of its
+     * connected outputs have ended, see Topology::waitDone().
+     * Do not produce on this port after posting end-of-stream.
+     */
+    void postEndOfStream(void);
+
+    /*!
+     * Configure the buffer manager that provides this port's stream buffers.
+     * The manager comes from the factory /framework/buffer_manager/<name>,
+     * such as "generic", "circular", or a plugin for special memory.
+     * Unless the args specify a node affinity, the buffers are allocated
+     * on the NUMA node of the block's thread pool.
+     * The manager can only be changed while the block is not active.
+     * An explicit manager is never replaced by Topology::commit().
+     * \throws BufferManagerFactoryError if the manager cannot be made
+     * \throws PortAccessError if the block is active
+     * \param name the name of the buffer manager factory
+     * \param args the number and size of the buffers
+     */
+    void setBufferManager(const std::string &name, const BufferManagerArgs &args = BufferManagerArgs());
+
+    /*!
+     * Allow in-place processing from an input port's buffer.
+     * Before work(), when the input buffer is held only by the framework,
+     * it is given to this output port in place of a buffer from the manager,
+     * so that elementwise blocks write their results over their inputs.
+     * The block must read each input element before writing its output,
+     * and must consume at least as many bytes as it produces.
+     * The input buffer is only forwarded when unique, so the block
+     * receives a normal output buffer when other readers share the input.
+     * \throws PortAccessError if the output elements are larger than the input's
+     * \param input the input port to borrow buffers from, or nullptr to disable
+     */
+    void setReadBeforeWrite(InputPort *input);
+
 private:
     OutputPortImpl *_impl;
     int _index;
@@ -30,12 +30,32 @@ public:
      * When the SharedBuffer is deleted, the memory will be freed as well.
      * The node affinity is used to allocate physical memory on a NUMA node.
      *
+     * Small allocations without a node affinity come from a slab pool:
+     * Freed memory is cached per thread by power of two size classes,
+     * so that frequent allocations of message and packet sized buffers
+     * are recycled without a call into the system allocator.
+     *
      * \param numBytes the number of bytes to allocate in this buffer
      * \param nodeAffinity which NUMA node to allocate on (-1 for dont care)
      * \return a new shared buffer object
      */
     static SharedBuffer make(const size_t numBytes, const long nodeAffinity = -1);
 
+    /*!
+     * Create a SharedBuffer backed by huge pages given a length in bytes.
+     * Large buffers see fewer TLB misses when backed by huge pages.
+     * The allocation tries explicit huge pages from the system's pool,
+     * then memory that is advised for transparent huge pages,
+     * and finally falls back to the allocation used by make().
+     * When huge pages are used, the length is rounded up
+     * to a multiple of the huge page size.
+     *
+     * \param numBytes the number of bytes to allocate in this buffer
+     * \param nodeAffinity which NUMA node to allocate on (-1 for dont care)
+     * \return a new shared buffer object
+     */
+    static SharedBuffer makeHuge(const size_t numBytes, const long nodeAffinity = -1);
+
     /*!
      * Create a circular SharedBuffer given a length in bytes.
      * The rules for the circular or double mapping are as follows:
@@ -100,6 +120,7 @@ public:
     bool null(void) const;
 
 private:
+    static SharedBuffer makeUnpooled(const size_t numBytes, const long nodeAffinity);
     static SharedBuffer makeCircUnprotected(const size_t numBytes, const long nodeAffinity);
     size_t _address;
     size_t _length;
@@ -0,0 +1,177 @@
+//
+// Framework/ThreadPool.hpp
+//
+// Thread pool configuration for the execution of blocks.
+//
+// Copyright (c) 2014-2014 Josh Blum
+// SPDX-License-Identifier: BSL-1.0
+//
+
+#pragma once
+#include <Pothos/Config.hpp>
+#include <memory> //shared_ptr
+#include <string>
+#include <vector>
+
+namespace Pothos {
+
+/*!
+ * ThreadPoolArgs - constructor arguments for ThreadPool.
+ */
+struct POTHOS_API ThreadPoolArgs
+{
+    //! Create a default thread pool args
+    ThreadPoolArgs(void);
+
+    //! Create a thread pool args with the specified number of threads
+    ThreadPoolArgs(const size_t numThreads);
+
+    /*!
+     * The number of worker threads in the pool.
+     * All blocks assigned to the pool are multiplexed onto these threads.
+     * Default: 0 -- use one thread per processor on the system (minimum of two)
+     */
+    size_t numThreads;
+
+    /*!
+     * Use a dedicated thread for each block in the pool.
+     * This is the one-thread-per-block execution mode:
+     * every block gets its own private single-threaded scheduler,
+     * and the numThreads argument is ignored.
+     * Default: false
+     */
+    bool threadPerBlock;
+
+    /*!
+     * Use the work-stealing scheduler for the worker threads.
+     * Each worker thread services its own queue of ready blocks,
+     * and idle worker threads steal ready blocks from the others.
+     * Otherwise all worker threads service a single shared queue.
+     * Default: false
+     */
+    bool workStealing;
+
+    /*!
+     * The yield mode of idle worker threads.
+     * CONDITION: the threads block on a condition variable.
+     * HYBRID: the threads spin, and then yield to other threads.
+     * SPIN: the threads busy-wait, for dedicated processors only.
+     * BACKOFF: the threads spin, then yield, and then sleep.
+     * The polling modes trade processor cycles for lower latency,
+     * and are best combined with a CPU affinity for the pool.
+     * Default: "CONDITION"
+     */
+    std::string yieldMode;
+
+    /*!
+     * The number of idle iterations spent spinning in BACKOFF yield mode.
+     * Default: 20
+     */
+    size_t backoffSpinCount;
+
+    /*!
+     * The number of idle iterations spent yielding in BACKOFF yield mode,
+     * after the spinning iterations and before the threads start to sleep.
+     * Default: 20
+     */
+    size_t backoffYieldCount;
+
+    /*!
+     * The sleep duration in milliseconds of idle threads in BACKOFF yield mode,
+     * once the spinning and yielding iterations are spent.
+     * The duration must be less than one second; 0 keeps yielding instead.
+     * Default: 1
+     */
+    size_t backoffSleepMs;
+
+    /*!
+     * The scheduling priority of the worker threads.
+     * The range is -1.0 (lowest) to 1.0 (highest).
+     * Default: 0.0 or normal priority
+     */
+    double priority;
+
+    /*!
+     * The affinity mode of the worker threads.
+     * ALL: the threads may run on any processor (affinity is ignored).
+     * CPU: the threads are pinned to the processors listed in affinity,
+     * given by their absolute processor index on the system.
+     * NUMA: the threads are pinned to the NUMA nodes listed in affinity.
+     * Default: "ALL"
+     */
+    std::string affinityMode;
+
+    /*!
+     * A list of processor indexes or NUMA node indexes.
+     * The interpretation of the list depends on the affinityMode.
+     * Default: empty
+     */
+    std::vector<size_t> affinity;
+};
+
+/*!
+ * A ThreadPool is a scheduler that executes the work of blocks.
+ * Each block is assigned to a thread pool, and many blocks may share
+ * the same thread pool, in which case the block's actors are
+ * multiplexed onto the pool's threads rather than running one thread each.
+ */
+class POTHOS_API ThreadPool
+{
+public:
+
+    //! Create a null thread pool
+    ThreadPool(void);
+
+    //! Create a thread pool from the args
+    ThreadPool(const ThreadPoolArgs &args);
+
+    /*!
+     * Get the process-wide default thread pool.
+     * Blocks are assigned this thread pool when they are constructed.
+     * The default pool is configured by the environment variables:
+     * POTHOS_NUM_THREADS specifies the number of worker threads,
+     * POTHOS_THREAD_PER_BLOCK=1 selects the one-thread-per-block mode,
+     * and POTHOS_YIELD_MODE specifies the yield mode of idle threads.
+     * The default pool is created on demand and is shared
+     * by all blocks in the process while any block holds it.
+     */
+    static ThreadPool getDefault(void);
+
+    /*!
+     * Is this thread pool null?
+     * \return true if it does not hold a thread pool.
+     */
+    bool null(void) const;
+
+    //! Get the args used to create this thread pool
+    const ThreadPoolArgs &getArgs(void) const;
+
+    /*!
+     * Get the NUMA node that the worker threads are confined to.
+     * Output buffers for blocks in this pool are allocated on this node.
+     * \return the node index, or -1 when the threads span several nodes
+     */
+    long getNodeAffinity(void) const;
+
+    /*!
+     * Get the underlying scheduler container.
+     * This is an opaque pointer for the framework internals;
+     * in the one-thread-per-block mode, each call creates a new container.
+     */
+    std::shared_ptr<void> getContainer(void) const;
+
+private:
+    struct Impl;
+    std::shared_ptr<Impl> _impl;
+    POTHOS_API friend bool operator==(const ThreadPool &lhs, const ThreadPool &rhs);
+};
+
+//! Are these thread pools the same scheduler instance?
+POTHOS_API bool operator==(const ThreadPool &lhs, const ThreadPool &rhs);
+
+} //namespace Pothos
+
+inline bool Pothos::ThreadPool::null(void) const
+{
+    return not _impl;
+}
@@ -11,6 +11,9 @@
 #include <Pothos/Config.hpp>
 #include <Pothos/Util/UID.hpp>
 #include <Pothos/Object/Object.hpp>
+#include <Pothos/Framework/ThreadPool.hpp>
+#include <Pothos/Framework/BufferManager.hpp>
+#include <Pothos/Framework/TopologyStats.hpp>
 #include <string>
 #include <memory>
 
@@ -44,6 +47,17 @@ public:
      * Once commit is called, actual data flow processing begins.
      * At this point the scheduler will call the block's work()
      * functions when the data at its inputs becomes available.
+     *
+     * When an input port has a reserve larger than one element,
+     * commit switches the upstream output port to a circular
+     * buffer manager that is large enough to hold the reserve,
+     * unless the output port's manager was configured explicitly.
+     *
+     * When fusion is enabled, commit fuses linear chains of blocks
+     * into one execution unit, see setFusionEnabled() for details.
+     *
+     * When a block has replicas, commit inserts the splitter
+     * and merger around the replicas, see addReplica() for details.
      */
     void commit(void);
 
@@ -58,6 +72,124 @@ public:
      */
     bool waitInactive(const double idleDuration = 0.1, const double timeout = 1.0);
 
+    /*!
+     * Wait for every block in the topology to finish its stream.
+     * A block is done when its connected inputs ended and a work()
+     * call after the end made no progress, or only a remainder
+     * below the reserve was left, see InputPort::setFlushAtEnd(),
+     * or for a block without connected inputs, when it posted
+     * end-of-stream on all of its connected outputs.
+     * Each block signals an event when it becomes done,
+     * so this call returns as soon as the last sink drains.
+     * See OutputPort::postEndOfStream() for end-of-stream.
+     * Note: end-of-stream does not cross network connections,
+     * so a topology that spans processes will not become done.
+     * \param timeout the maximum number of seconds to wait in this call
+     * \return true if all blocks were done before the timeout
+     */
+    bool waitDone(const double timeout = 1.0);
+
+    /*!
+     * Query a performance snapshot of the active topology.
+     * The stats of every block, including blocks in remote processes,
+     * are requested together before waiting on any of the replies.
+     * \return the stats of all blocks and flows in the flattened topology
+     */
+    TopologyStats queryStats(void);
+
+    /*!
+     * Set the thread pool configuration for the blocks in this topology.
+     * Without this call, blocks execute in the default thread pool.
+     * Once set, commit() assigns a thread pool created from these args
+     * to every block that newly enters the active data flow.
+     * Blocks residing in the same process share one thread pool.
+     * \param args the thread pool args used for this topology
+     */
+    void setThreadPoolArgs(const ThreadPoolArgs &args);
+
+    /*!
+     * Configure a named affinity group for the blocks in this topology.
+     * Blocks assigned to the group execute in a thread pool created
+     * from these args, for example a pool pinned to a set of processors.
+     * Each affinity group gets its own thread pool per process.
+     * \param group the name of the affinity group
+     * \param args the thread pool args used for this group
+     */
+    void setThreadPoolArgs(const std::string &group, const ThreadPoolArgs &args);
+
+    /*!
+     * Assign a block to a named affinity group.
+     * The group must be configured with setThreadPoolArgs(group, args).
+     * The assignment takes effect when commit() activates the block;
+     * blocks which are already active keep their current thread pool.
+     * \param obj the block (local/remote block)
+     * \param group the name of the affinity group
+     */
+    template <typename ObjType>
+    void setAffinityGroup(ObjType &&obj, const std::string &group);
+
+    /*!
+     * Configure the buffer manager for an output port of a block.
+     * See OutputPort::setBufferManager() for the manager and args.
+     * The configuration takes effect when commit() activates the block;
+     * blocks which are already active keep their current buffer manager.
+     * \param obj the block (local/remote block)
+     * \param port an identifier for the output port (string or index)
+     * \param name the name of the buffer manager factory
+     * \param args the number and size of the buffers
+     */
+    template <typename ObjType, typename PortType>
+    void setBufferManager(ObjType &&obj, const PortType &port, const std::string &name, const BufferManagerArgs &args);
+
+    /*!
+     * Enable the fusion of linear chains of blocks in this topology.
+     * A chain is a sequence of blocks in the same process and the same
+     * affinity group, where each block has a single downstream flow
+     * into a block with a single upstream flow. Blocks that were given
+     * a thread pool with Block::setThreadPool() are never fused.
+     * The blocks of a chain share a single-threaded thread pool,
+     * configured from the chain's affinity group,
+     * and port messages within the chain are handled by direct calls,
+     * so that each work() runs in sequence on cache-hot buffers.
+     * Labels and messages are delivered in the same order as before.
+     * Fusion takes effect when commit() activates the blocks;
+     * blocks which are already active keep their current thread pool.
+     * Default: fusion is disabled.
+     * \param enabled true to fuse eligible chains
+     */
+    void setFusionEnabled(const bool enabled);
+
+    /*!
+     * Switch fusion on or off for a single block.
+     * A block that is switched off never joins a fused chain,
+     * for example a block whose work() blocks on external events.
+     * Blocks are switched on by default, but only fused when
+     * fusion is enabled for the topology with setFusionEnabled().
+     * \param obj the block (local/remote block)
+     * \param enabled false to keep the block out of fused chains
+     */
+    template <typename ObjType>
+    void setFusionEnabled(ObjType &&obj, const bool enabled);
+
+    /*!
+     * Add a replica to share the load of a stateless block.
+     * The replica is a separate instance of the same block,
+     * created with the same arguments, that is not connected.
+     * On commit(), the block and its replicas are placed behind a
+     * splitter that deals the input stream to them in round-robin chunks,
+     * and in front of a merger that restores the order of the chunks.
+     * Labels keep their offsets in the stream through the replicas,
+     * but async messages are not ordered across the replicas.
+     * The block must have one connected input and one connected output port,
+     * and produce one output element for every input element it consumes,
+     * for example a type converter or an elementwise math block.
+     * Replicas without an affinity group join the group of the block.
+     * \param obj the replicated block (local/remote block)
+     * \param replica another instance of the block
+     */
+    template <typename ObjType, typename ReplicaType>
+    void addReplica(ObjType &&obj, ReplicaType &&replica);
+
     /*!
      * Create a connection between a source port and a destination port.
      * \param src the data source (local/remote block/topology)
@@ -101,6 +233,10 @@ private:
     void _disconnect(
         const Object &src, const std::string &srcPort,
         const Object &dst, const std::string &dstPort);
+    void _setAffinityGroup(const Object &obj, const std::string &group);
+    void _setBufferManager(const Object &obj, const std::string &port, const std::string &name, const BufferManagerArgs &args);
+    void _setFusionEnabled(const Object &obj, const bool enabled);
+    void _addReplica(const Object &obj, const Object &replica);
 
 public:
     struct Impl;
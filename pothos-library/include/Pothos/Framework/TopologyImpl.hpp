@@ -98,7 +98,7 @@ portNameToStr(const T &value)
 } //namespace Pothos
 
 /***********************************************************************
- * templated implementation for connect and disconnect
+ * templated implementation for connect, disconnect, and port config
  **********************************************************************/
 template <
     typename SrcType, typename SrcPortType,
@@ -123,3 +123,27 @@ void Pothos::Topology::disconnect(
         Detail::connObjToObject(src), Detail::portNameToStr(srcPort),
         Detail::connObjToObject(dst), Detail::portNameToStr(dstPort));
 }
+
+template <typename ObjType>
+void Pothos::Topology::setAffinityGroup(ObjType &&obj, const std::string &group)
+{
+    this->_setAffinityGroup(Detail::connObjToObject(obj), group);
+}
+
+template <typename ObjType>
+void Pothos::Topology::setFusionEnabled(ObjType &&obj, const bool enabled)
+{
+    this->_setFusionEnabled(Detail::connObjToObject(obj), enabled);
+}
+
+template <typename ObjType, typename ReplicaType>
+void Pothos::Topology::addReplica(ObjType &&obj, ReplicaType &&replica)
+{
+    this->_addReplica(Detail::connObjToObject(obj), Detail::connObjToObject(replica));
+}
+
+template <typename ObjType, typename PortType>
+void Pothos::Topology::setBufferManager(ObjType &&obj, const PortType &port, const std::string &name, const BufferManagerArgs &args)
+{
+    this->_setBufferManager(Detail::connObjToObject(obj), Detail::portNameToStr(port), name, args);
+}
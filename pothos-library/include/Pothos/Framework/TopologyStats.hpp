@@ -0,0 +1,103 @@
+//
+// Framework/TopologyStats.hpp
+//
+// This file contains a performance snapshot of a topology.
+//
+// Copyright (c) 2014-2014 Josh Blum
+// SPDX-License-Identifier: BSL-1.0
+//
+
+#pragma once
+#include <Pothos/Config.hpp>
+#include <string>
+#include <vector>
+
+namespace Pothos {
+
+/*!
+ * Performance counters of a single block in a topology snapshot.
+ */
+struct POTHOS_API BlockStats
+{
+    //! Create zeroed block stats
+    BlockStats(void);
+
+    //! The unique identifier of the block
+    std::string uid;
+
+    //! Seconds since the block was activated
+    double elapsedTime;
+
+    //! Seconds spent in work() and the pre and post work tasks
+    double workTime;
+
+    //! The fraction of the topology's total work time used by this block
+    double cpuShare;
+
+    //! The number of calls to work()
+    unsigned long long numWorkCalls;
+
+    /*!
+     * Log-scale histogram of the work() durations:
+     * Entry i>0 counts the calls that lasted between 2^(i-1) and 2^i nanoseconds,
+     * entry 0 counts the calls that lasted under a nanosecond.
+     */
+    std::vector<unsigned long long> workHistogram;
+};
+
+/*!
+ * Performance counters of a single flow in a topology snapshot.
+ * The stream counters come from the source port,
+ * since every subscriber of a port receives the entire stream.
+ * The queue depths come from the destination port,
+ * and include data from all flows into that port.
+ */
+struct POTHOS_API EdgeStats
+{
+    //! Create zeroed edge stats
+    EdgeStats(void);
+
+    std::string srcUid; //!< the unique identifier of the source block
+    std::string srcPort; //!< the name of the source output port
+    std::string dstUid; //!< the unique identifier of the destination block
+    std::string dstPort; //!< the name of the destination input port
+
+    unsigned long long totalElements; //!< elements produced into the flow
+    unsigned long long totalMessages; //!< messages posted into the flow
+    unsigned long long totalLabels; //!< labels posted into the flow
+
+    //! Elements per second since the source block was activated
+    double elementRate;
+
+    unsigned long long queuedElements; //!< elements waiting at the destination
+    unsigned long long queuedMessages; //!< messages waiting at the destination
+    unsigned long long queuedLabels; //!< labels waiting at the destination
+
+    //! Seconds the source port waited on a buffer or a throttled consumer
+    double srcBlockedTime;
+
+    //! Seconds the destination port was starved of data
+    double dstBlockedTime;
+};
+
+/*!
+ * A performance snapshot of all blocks and flows in a topology.
+ * Hierarchy is flattened: the blocks and flows are the ones
+ * that actually process data, including remote blocks.
+ */
+struct POTHOS_API TopologyStats
+{
+    //! The stats of every block in the topology
+    std::vector<BlockStats> blocks;
+
+    //! The stats of every flow in the topology
+    std::vector<EdgeStats> edges;
+
+    //! Dump the snapshot as a JSON object with "blocks" and "edges" arrays
+    std::string toJSON(void) const;
+
+    //! Dump the snapshot as a graphviz digraph, labeled with the key counters
+    std::string toDotMarkup(void) const;
+};
+
+} //namespace Pothos
@@ -0,0 +1,51 @@
+//
+// Framework/Trace.hpp
+//
+// Tracing of worker activity for offline timeline analysis.
+//
+// Copyright (c) 2014-2014 Josh Blum
+// SPDX-License-Identifier: BSL-1.0
+//
+
+#pragma once
+#include <Pothos/Config.hpp>
+#include <string>
+
+namespace Pothos {
+namespace Trace {
+
+    /*!
+     * Enable or disable tracing of the workers in this process.
+     * When enabled, the workers record their pre-work, work and post-work
+     * spans, and the port messages that they send and receive.
+     * Each thread records into its own ring buffer without locking;
+     * a ring holds the most recent events of its thread.
+     * The ring of an exited thread is reused by the next new thread,
+     * so the two threads share a thread id in the dump.
+     * Tracing is disabled by default, and costs one flag check when disabled.
+     */
+    POTHOS_API void setEnabled(const bool enabled);
+
+    //! Is the tracing of workers enabled?
+    POTHOS_API bool isEnabled(void);
+
+    //! Discard the events recorded so far
+    POTHOS_API void clear(void);
+
+    /*!
+     * Dump the recorded events in the Chrome trace-event JSON format.
+     * The result can be loaded into chrome://tracing or Perfetto.
+     * Dump when the topology is idle or tracing is disabled,
+     * otherwise the dump may contain events that were being overwritten.
+     */
+    POTHOS_API std::string toJSON(void);
+
+    /*!
+     * Write the recorded events to a file as Chrome trace-event JSON.
+     * \throws FileException when the file cannot be written
+     * \param path the path of the output file
+     */
+    POTHOS_API void writeFile(const std::string &path);
+
+} //namespace Trace
+} //namespace Pothos
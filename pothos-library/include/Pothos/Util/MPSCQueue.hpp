@@ -0,0 +1,138 @@
+//
+// Util/MPSCQueue.hpp
+//
+// A bounded lock-free multi-producer single-consumer queue.
+//
+// Copyright (c) 2013-2014 Josh Blum
+// SPDX-License-Identifier: BSL-1.0
+//
+
+#pragma once
+#include <Pothos/Config.hpp>
+#include <cstdlib> //size_t
+#include <cstddef> //ptrdiff_t
+#include <atomic>
+#include <memory> //unique_ptr
+
+namespace Pothos {
+namespace Util {
+
+/*!
+ * MPSCQueue is a bounded queue with lock-free push and pop.
+ * Any number of threads may push, but only one thread may pop.
+ * Each slot holds a sequence number which tells the consumer
+ * when the element was published, so that the producers only
+ * contend on a single atomic increment of the enqueue position.
+ * The capacity is rounded up to the next power of two, and at least two:
+ * with a single slot, a published sequence number would also read as free.
+ */
+template <typename T>
+class MPSCQueue
+{
+public:
+    //! Construct a new queue -- with a capacity of 2
+    MPSCQueue(void);
+
+    //! Construct a new queue -- with space reservation
+    MPSCQueue(const size_t capacity);
+
+    //! Push an element onto the back of the queue (thread-safe)
+    bool push(const T &elem);
+
+    //! Pop an element from the front of the queue (single consumer)
+    bool pop(T &elem);
+
+    //! How many elements can be stored?
+    size_t capacity(void) const;
+
+    //! Set the queue capacity -- not thread-safe, and discards elements
+    void set_capacity(const size_t capacity);
+
+private:
+    struct Cell
+    {
+        std::atomic<size_t> seq;
+        T elem;
+    };
+    std::unique_ptr<Cell[]> _cells;
+    size_t _mask;
+    std::atomic<size_t> _enqueuePos;
+    size_t _dequeuePos;
+};
+
+template <typename T>
+MPSCQueue<T>::MPSCQueue(void)
+{
+    this->set_capacity(1);
+}
+
+template <typename T>
+MPSCQueue<T>::MPSCQueue(const size_t capacity)
+{
+    this->set_capacity(capacity);
+}
+
+template <typename T>
+bool MPSCQueue<T>::push(const T &elem)
+{
+    size_t pos = _enqueuePos.load(std::memory_order_relaxed);
+    Cell *cell = nullptr;
+    while (true)
+    {
+        cell = &_cells[pos & _mask];
+        const size_t seq = cell->seq.load(std::memory_order_acquire);
+        const ptrdiff_t diff = ptrdiff_t(seq) - ptrdiff_t(pos);
+
+        //the slot is free, try to claim it
+        if (diff == 0)
+        {
+            if (_enqueuePos.compare_exchange_weak(pos, pos+1, std::memory_order_relaxed)) break;
+        }
+
+        //the slot is still in use, the queue is full
+        else if (diff < 0) return false;
+
+        //another producer claimed the slot, reload the position
+        else pos = _enqueuePos.load(std::memory_order_relaxed);
+    }
+
+    cell->elem = elem;
+    cell->seq.store(pos+1, std::memory_order_release);
+    return true;
+}
+
+template <typename T>
+bool MPSCQueue<T>::pop(T &elem)
+{
+    Cell &cell = _cells[_dequeuePos & _mask];
+    const size_t seq = cell.seq.load(std::memory_order_acquire);
+    if (seq != _dequeuePos+1) return false;
+
+    elem = std::move(cell.elem);
+    cell.elem = T();
+    cell.seq.store(_dequeuePos+_mask+1, std::memory_order_release);
+    _dequeuePos++;
+    return true;
+}
+
+template <typename T>
+size_t MPSCQueue<T>::capacity(void) const
+{
+    return _mask+1;
+}
+
+template <typename T>
+void MPSCQueue<T>::set_capacity(const size_t capacity)
+{
+    size_t size = 2;
+    while (size < capacity) size <<= 1;
+
+    _cells.reset(new Cell[size]);
+    for (size_t i = 0; i < size; i++) _cells[i].seq.store(i, std::memory_order_relaxed);
+    _mask = size-1;
+    _enqueuePos.store(0, std::memory_order_relaxed);
+    _dequeuePos = 0;
+}
+
+} //namespace Util
+} //namespace Pothos
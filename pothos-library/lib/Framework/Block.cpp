@@ -3,9 +3,24 @@
 
 #include "Framework/WorkerActor.hpp"
 
+static std::shared_ptr<Theron::Framework> getThreadPoolFramework(const Pothos::ThreadPool &threadPool)
+{
+    //in the one thread per block mode, every call makes a new framework
+    return std::static_pointer_cast<Theron::Framework>(threadPool.getContainer());
+}
+
+static std::shared_ptr<Pothos::WorkerActor> makeWorkerActor(Pothos::Block *block, std::shared_ptr<Theron::Framework> framework)
+{
+    //the actor holds the framework until its deregistered from it,
+    //since references to the actor may outlive the block's framework
+    return std::shared_ptr<Pothos::WorkerActor>(new Pothos::WorkerActor(block),
+        [framework](Pothos::WorkerActor *actor){delete actor;});
+}
+
 Pothos::Block::Block(void):
-    _framework(new Theron::Framework(1)),
-    _actor(new WorkerActor(this))
+    _threadPool(ThreadPool::getDefault()),
+    _framework(getThreadPoolFramework(_threadPool)),
+    _actor(makeWorkerActor(this, _framework))
 {
     std::cout << "new Actor " << _actor->GetAddress().AsString() << std::endl;
     return;
@@ -125,6 +140,41 @@ void Pothos::Block::registerCallable(const std::string &name, const Callable &ca
     _actor->calls[name] = call;
 }
 
+void Pothos::Block::setThreadPool(const ThreadPool &threadPool)
+{
+    if (threadPool.null()) throw ThreadPoolError("Pothos::Block::setThreadPool()", "null thread pool");
+    if (threadPool == _threadPool) return;
+    if (_actor->active) throw ThreadPoolError("Pothos::Block::setThreadPool()", "block is active");
+    if (_actor->hasSubscribers()) throw ThreadPoolError("Pothos::Block::setThreadPool()", "block ports are connected");
+
+    //flush messages that are still pending in the old actor's queue,
+    //the flush message takes the normal lane behind the pending messages
+    {
+        InfoReceiver<FlushActorMessage> receiver;
+        _framework->Send(FlushActorMessage(), receiver.GetAddress(), _actor->GetAddress());
+        receiver.WaitInfo();
+    }
+
+    //create a new actor in the new framework and move the state over;
+    //hold the old framework until the old actor is released
+    auto oldFramework = _framework;
+    auto oldActor = _actor;
+    const bool nodeChanged = _threadPool.getNodeAffinity() != threadPool.getNodeAffinity();
+    _threadPool = threadPool;
+    _framework = getThreadPoolFramework(_threadPool);
+    _actor = makeWorkerActor(this, _framework);
+    _actor->moveState(*oldActor);
+    oldActor.reset();
+
+    //reallocate the output buffers on the node of the new thread pool
+    if (nodeChanged) _actor->setupBufferManagers();
+}
+
+const Pothos::ThreadPool &Pothos::Block::getThreadPool(void) const
+{
+    return _threadPool;
+}
+
 std::vector<Pothos::PortInfo> Pothos::Block::inputPortInfo(void)
 {
     InfoReceiver<std::vector<PortInfo>> receiver;
@@ -200,6 +250,8 @@ static auto managedBlock = Pothos::ManagedClass()
     .registerMethod(POTHOS_FCN_TUPLE(Pothos::Block, allOutputs))
     .registerMethod<const std::string &>(POTHOS_FCN_TUPLE(Pothos::Block, output))
     .registerMethod<const size_t>(POTHOS_FCN_TUPLE(Pothos::Block, output))
+    .registerMethod(POTHOS_FCN_TUPLE(Pothos::Block, setThreadPool))
+    .registerMethod(POTHOS_FCN_TUPLE(Pothos::Block, getThreadPool))
     .commit("Pothos/Block");
 
 template <typename PortType>
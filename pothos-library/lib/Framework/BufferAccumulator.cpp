@@ -4,45 +4,96 @@
 #include <Pothos/Framework/BufferAccumulator.hpp>
 #include <Pothos/Framework/BufferManager.hpp>
 #include <Pothos/Util/RingDeque.hpp>
+#include <Pothos/Util/MPSCQueue.hpp>
 #include <cstring> //memcpy
 #include <cassert>
 
 /***********************************************************************
- * SharedBufferPool
+ * HelperBufferPool - power of two size classes:
+ * Each size class keeps a bounded queue of free buffers.
+ * A pooled buffer returns itself to the queue of its class
+ * when the last reference is released, from any thread context.
+ * Buffers are freed instead when the queue of the class is full,
+ * and requests larger than the biggest class are not pooled.
  **********************************************************************/
 class HelperBufferPool
 {
 public:
+    static const size_t MIN_CLASS_BITS = 12; //4 KiB
+    static const size_t NUM_CLASSES = 9; //up to 1 MiB
+    static const size_t MAX_RETAINED = 4; //free buffers per class
+
     HelperBufferPool(void):
-        _minBuffSize(4096)
+        _state(std::make_shared<State>()),
+        hits(0),
+        misses(0)
     {
         return;
     }
 
     Pothos::BufferChunk get(const size_t numBytes)
     {
-        //user asked for a larger buffer size -- drop all entries
-        if (numBytes > _minBuffSize)
+        //find the smallest class that holds the requested bytes
+        size_t sizeClass = 0;
+        while (sizeClass < NUM_CLASSES and (size_t(1) << (sizeClass+MIN_CLASS_BITS)) < numBytes) sizeClass++;
+
+        //too large for the pool -- a one time allocation
+        if (sizeClass == NUM_CLASSES)
         {
-            _buffs.clear();
-            _minBuffSize = numBytes;
+            misses++;
+            return Pothos::BufferChunk(Pothos::SharedBuffer::make(numBytes));
         }
 
-        //find the first buffer where we hold the only copy
-        for (size_t i = 0; i < _buffs.size(); i++)
+        //reuse a free buffer from the class, otherwise make a new one
+        Pothos::SharedBuffer backing;
+        if (_state->freeBuffs[sizeClass].pop(backing)) hits++;
+        else
         {
-            if (_buffs[i].getBuffer().unique()) return _buffs[i];
+            misses++;
+            backing = Pothos::SharedBuffer::make(size_t(1) << (sizeClass+MIN_CLASS_BITS));
         }
 
-        //otherwise make a new buffer
-        _buffs.push_back(Pothos::BufferChunk(
-            Pothos::SharedBuffer::make(_minBuffSize)));
-        return _buffs.back();
+        //the container returns the backing buffer to the pool on release
+        std::shared_ptr<void> container((void *)backing.getAddress(), Release(_state, sizeClass, backing));
+        return Pothos::BufferChunk(Pothos::SharedBuffer(backing.getAddress(), backing.getLength(), container));
     }
 
 private:
-    size_t _minBuffSize;
-    std::vector <Pothos::BufferChunk> _buffs;
+    struct State
+    {
+        State(void)
+        {
+            for (auto &queue : freeBuffs) queue.set_capacity(MAX_RETAINED);
+        }
+        Pothos::Util::MPSCQueue<Pothos::SharedBuffer> freeBuffs[NUM_CLASSES];
+    };
+
+    struct Release
+    {
+        Release(const std::shared_ptr<State> &state, const size_t sizeClass, const Pothos::SharedBuffer &backing):
+            state(state), sizeClass(sizeClass), backing(backing)
+        {
+            return;
+        }
+
+        void operator()(void *)
+        {
+            //a full class frees the buffer to bound the retained memory
+            state->freeBuffs[sizeClass].push(backing);
+            backing = Pothos::SharedBuffer();
+            state.reset();
+        }
+
+        std::shared_ptr<State> state;
+        size_t sizeClass;
+        Pothos::SharedBuffer backing;
+    };
+
+    std::shared_ptr<State> _state;
+
+public:
+    unsigned long long hits;
+    unsigned long long misses;
 };
 
 /***********************************************************************
@@ -144,9 +195,9 @@ void Pothos::BufferAccumulator::pop(const size_t numBytes)
     //If the front buffer is from the pool,
     //and the remainder bytes are in front+1,
     //then pop the front and move into front+1.
-    assert(_impl->inPoolBuffer == 0 or queue.size() > 1);
+    //The pool buffer may be alone when require() drained the queue.
     if (
-        _impl->inPoolBuffer and //pool in front
+        _impl->inPoolBuffer and queue.size() > 1 and //pool in front
         queue.front().length <= (queue[1].address - queue[1].getBuffer().getAddress()))
     {
         queue[1].address -= queue.front().length;
@@ -156,24 +207,29 @@ void Pothos::BufferAccumulator::pop(const size_t numBytes)
     }
 
     //pop the front buffer if its now empty
-    else if (queue.front().length == 0) queue.pop_front();
+    else if (queue.front().length == 0)
+    {
+        queue.pop_front();
+        _impl->inPoolBuffer = false;
+    }
 
     //If we passed the boundary of the front buffer,
     //and the front-1 buffer is contiguous with front,
     //then we can move into the front-1 and pop front.
-    else if (queue.size() > 1)
+    //Front may also continue into the circular alias of front-1.
+    //Repeat so that front never holds a buffer it has passed.
+    else while (queue.size() > 1)
     {
         BufferChunk &f = queue[0];
         BufferChunk &b = queue[1];
         assert(not b.null());
         assert(not f.null());
         const bool fOverBounds = f.address >= (f.getBuffer().getEnd());
-        if (fOverBounds and f.getEnd() == b.address)
-        {
-            b.address -= f.length;
-            b.length =+ f.length;
-            queue.pop_front();
-        }
+        if (not fOverBounds) break;
+        if (f.getEnd() != b.address and f.getEnd() != b.getAlias()) break;
+        b.address -= f.length;
+        b.length += f.length;
+        queue.pop_front();
     }
 
     //never let the queue become empty -- hold an empty buffer
@@ -233,3 +289,13 @@ void Pothos::BufferAccumulator::require(const size_t numBytes)
     _impl->inPoolBuffer = true;
     queue.push_front(newBuffer);
 }
+
+unsigned long long Pothos::BufferAccumulator::getPoolHits(void) const
+{
+    return _impl->pool.hits;
+}
+
+unsigned long long Pothos::BufferAccumulator::getPoolMisses(void) const
+{
+    return _impl->pool.misses;
+}
@@ -9,7 +9,15 @@
 Pothos::BufferManagerArgs::BufferManagerArgs(void):
     numBuffers(4),
     bufferSize(8*1024),
-    nodeAffinity(-1)
+    nodeAffinity(-1),
+    hugePages(false)
+{
+    return;
+}
+
+Pothos::BufferManager::BufferManager(void):
+    _starved(false),
+    _hasOverflow(false)
 {
     return;
 }
@@ -22,6 +30,7 @@ Pothos::BufferManager::Sptr Pothos::BufferManager::make(const std::string &name,
         auto plugin = Pothos::PluginRegistry::get(Pothos::PluginPath("/framework/buffer_manager").join(name));
         auto callable = plugin.getObject().extract<Pothos::Callable>();
         manager = callable.call<Sptr>();
+        manager->_returnQueue.set_capacity(args.numBuffers);
         manager->init(args);
     }
     catch(const Exception &ex)
@@ -31,7 +40,37 @@ Pothos::BufferManager::Sptr Pothos::BufferManager::make(const std::string &name,
     return manager;
 }
 
-void Pothos::BufferManager::setCallback(const std::function<void(const ManagedBuffer &)> &callback)
+size_t Pothos::BufferManager::numReady(void) const
+{
+    return this->empty()?0:1;
+}
+
+void Pothos::BufferManager::setCallback(const std::function<void(void)> &callback)
 {
     _callback = callback;
 }
+
+#include <Pothos/Managed.hpp>
+
+static auto managedBufferManagerArgs = Pothos::ManagedClass()
+    .registerConstructor<Pothos::BufferManagerArgs>()
+    .registerField(POTHOS_FCN_TUPLE(Pothos::BufferManagerArgs, numBuffers))
+    .registerField(POTHOS_FCN_TUPLE(Pothos::BufferManagerArgs, bufferSize))
+    .registerField(POTHOS_FCN_TUPLE(Pothos::BufferManagerArgs, nodeAffinity))
+    .registerField(POTHOS_FCN_TUPLE(Pothos::BufferManagerArgs, hugePages))
+    .commit("Pothos/BufferManagerArgs");
+
+#include <Pothos/Object/Serialize.hpp>
+
+namespace Pothos { namespace serialization {
+template <class Archive>
+void serialize(Archive &ar, Pothos::BufferManagerArgs &t, const unsigned int)
+{
+    ar & t.numBuffers;
+    ar & t.bufferSize;
+    ar & t.nodeAffinity;
+    ar & t.hugePages;
+}
+}}
+
+POTHOS_OBJECT_SERIALIZE(Pothos::BufferManagerArgs)
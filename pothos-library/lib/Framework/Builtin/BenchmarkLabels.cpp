@@ -0,0 +1,126 @@
+// Copyright (c) 2014-2014 Josh Blum
+// SPDX-License-Identifier: BSL-1.0
+
+#include <Pothos/Testing.hpp>
+#include <Pothos/Framework.hpp>
+#include <Poco/Timestamp.h>
+#include <Poco/Thread.h>
+#include <Poco/Format.h>
+#include <algorithm> //min
+#include <iterator> //distance
+#include <iostream>
+#include <atomic>
+
+/***********************************************************************
+ * Tag-heavy stream:
+ * The source labels every Nth element that it produces,
+ * a relay forwards the stream with the default label propagation,
+ * and the sink counts the labels that arrive.
+ **********************************************************************/
+struct LabelSource : Pothos::Block
+{
+    LabelSource(const size_t total, const size_t spacing):
+        total(total),
+        spacing(spacing),
+        count(0)
+    {
+        this->setupOutput(0, "int32");
+    }
+
+    void work(void)
+    {
+        auto out = this->output(0);
+        const size_t n = std::min(out->elements(), total-count);
+        for (size_t i = 0; i < n; i++)
+        {
+            if ((count+i) % spacing == 0) out->postLabel(Pothos::Label(Pothos::Object(), count+i));
+        }
+        count += n;
+        out->produce(n);
+    }
+
+    const size_t total;
+    const size_t spacing;
+    size_t count;
+};
+
+struct LabelRelay : Pothos::Block
+{
+    LabelRelay(void)
+    {
+        this->setupInput(0, "int32");
+        this->setupOutput(0, "int32");
+    }
+
+    void work(void)
+    {
+        auto in = this->input(0);
+        const size_t n = in->elements();
+        if (n == 0) return;
+        auto buffer = in->buffer();
+        this->output(0)->postBuffer(buffer);
+        in->consume(n);
+    }
+};
+
+struct LabelSink : Pothos::Block
+{
+    LabelSink(void):
+        count(0),
+        numLabels(0)
+    {
+        this->setupInput(0, "int32");
+    }
+
+    void work(void)
+    {
+        auto in = this->input(0);
+        count += in->elements();
+        in->consume(in->elements());
+    }
+
+    void propagateLabels(const Pothos::InputPort *, const Pothos::LabelIteratorRange &labels)
+    {
+        numLabels += std::distance(labels.begin(), labels.end());
+    }
+
+    std::atomic<size_t> count;
+    size_t numLabels;
+};
+
+static double runLabelBenchmark(const size_t spacing)
+{
+    const size_t total = 1 << 16; //smoke-test size, this runs with the self tests
+    auto source = std::make_shared<LabelSource>(total, spacing);
+    auto relay = std::make_shared<LabelRelay>();
+    auto sink = std::make_shared<LabelSink>();
+
+    const Poco::Timestamp startTime;
+    {
+        Pothos::Topology topology;
+        topology.connect(source, 0, relay, 0);
+        topology.connect(relay, 0, sink, 0);
+        topology.commit();
+
+        //wait for all elements to arrive at the sink
+        while (sink->count < total and startTime.elapsed() < 10*1000*1000)
+        {
+            Poco::Thread::sleep(1);
+        }
+    }
+
+    POTHOS_TEST_EQUAL(sink->count, total);
+    POTHOS_TEST_EQUAL(sink->numLabels, (total+spacing-1)/spacing);
+    return sink->numLabels/(startTime.elapsed()/1e6);
+}
+
+POTHOS_TEST_BLOCK("/framework/benchmarks", benchmark_labels)
+{
+    std::cout << "label throughput through a relay" << std::endl;
+    for (size_t spacing = 64; spacing >= 4; spacing /= 4)
+    {
+        const double rate = runLabelBenchmark(spacing);
+        std::cout << Poco::format("  one label per %d elements: %0.2f Mlabels/s",
+            int(spacing), rate/1e6) << std::endl;
+    }
+}
@@ -0,0 +1,199 @@
+// Copyright (c) 2014-2014 Josh Blum
+// SPDX-License-Identifier: BSL-1.0
+
+#include <Pothos/Testing.hpp>
+#include <Pothos/Framework.hpp>
+#include <Poco/Event.h>
+#include <Poco/Format.h>
+#include <algorithm> //sort, min
+#include <iostream>
+#include <chrono>
+
+static long long latencyNowNs(void)
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::high_resolution_clock::now().time_since_epoch()).count();
+}
+
+/***********************************************************************
+ * Ping messages through a chain of relays:
+ * The pinger posts a timestamped message when its ping() call is made,
+ * the relays forward the message, and the sink records the latency.
+ **********************************************************************/
+struct LatencyPinger : Pothos::Block
+{
+    LatencyPinger(void)
+    {
+        this->setupOutput(0, "byte");
+        this->registerCall(POTHOS_FCN_TUPLE(LatencyPinger, ping));
+
+        //an unconnected input with a reserve keeps work() from spinning between pings
+        this->setupInput(0, "byte");
+        this->input(0)->setReserve(1);
+    }
+
+    void ping(void)
+    {
+        this->output(0)->postMessage(Pothos::Object(latencyNowNs()));
+    }
+};
+
+struct LatencyRelay : Pothos::Block
+{
+    LatencyRelay(void)
+    {
+        this->setupInput(0, "byte");
+        this->setupOutput(0, "byte");
+        this->input(0)->setReserve(1);
+    }
+
+    void work(void)
+    {
+        auto in = this->input(0);
+        while (in->hasMessage()) this->output(0)->postMessage(in->popMessage());
+    }
+};
+
+struct LatencySink : Pothos::Block
+{
+    LatencySink(void)
+    {
+        this->setupInput(0, "byte");
+        this->input(0)->setReserve(1);
+    }
+
+    void work(void)
+    {
+        auto in = this->input(0);
+        while (in->hasMessage())
+        {
+            const auto sent = in->popMessage().convert<long long>();
+            latencies.push_back(latencyNowNs() - sent);
+            received.set();
+        }
+    }
+
+    std::vector<long long> latencies;
+    Poco::Event received;
+};
+
+static void runLatencyBenchmark(const std::string &yieldMode)
+{
+    const size_t numRelays = 4;
+    const size_t numWarmup = 100;
+    const size_t numPings = 2000;
+
+    Pothos::ThreadPoolArgs args(2);
+    args.yieldMode = yieldMode;
+
+    auto pinger = std::make_shared<LatencyPinger>();
+    auto sink = std::make_shared<LatencySink>();
+    std::vector<std::shared_ptr<LatencyRelay>> relays;
+    for (size_t i = 0; i < numRelays; i++) relays.emplace_back(new LatencyRelay());
+
+    std::vector<long long> latencies;
+    {
+        Pothos::Topology topology;
+        topology.setThreadPoolArgs(args);
+        topology.connect(pinger, 0, relays.front(), 0);
+        for (size_t i = 1; i < numRelays; i++) topology.connect(relays[i-1], 0, relays[i], 0);
+        topology.connect(relays.back(), 0, sink, 0);
+        topology.commit();
+
+        //one ping in flight at a time, wait for the sink before the next
+        for (size_t i = 0; i < numWarmup+numPings; i++)
+        {
+            pinger->opaqueCall("ping", nullptr, 0);
+            POTHOS_TEST_TRUE(sink->received.tryWait(1000));
+        }
+        POTHOS_TEST_TRUE(topology.waitInactive(0.01, 1.0));
+        latencies.assign(sink->latencies.begin()+numWarmup, sink->latencies.end());
+    }
+
+    POTHOS_TEST_EQUAL(latencies.size(), numPings);
+    std::sort(latencies.begin(), latencies.end());
+    const auto p50 = latencies[latencies.size()*50/100];
+    const auto p99 = latencies[latencies.size()*99/100];
+    std::cout << Poco::format("  %s: p50 %0.1f us, p99 %0.1f us",
+        yieldMode, p50/1e3, p99/1e3) << std::endl;
+}
+
+POTHOS_TEST_BLOCK("/framework/benchmarks", benchmark_latency)
+{
+    std::cout << "end-to-end latency through a chain of relays" << std::endl;
+    runLatencyBenchmark("CONDITION");
+    runLatencyBenchmark("HYBRID");
+    runLatencyBenchmark("BACKOFF");
+    runLatencyBenchmark("SPIN");
+}
+
+/***********************************************************************
+ * Call a block while its mailbox is flooded with small buffers:
+ * The round trip time of the call shows how long control messages
+ * wait behind the stream data that is queued at the block.
+ **********************************************************************/
+struct FloodSource : Pothos::Block
+{
+    FloodSource(void)
+    {
+        this->setupOutput(0, "int32");
+    }
+
+    void work(void)
+    {
+        auto out = this->output(0);
+        out->produce(std::min<size_t>(out->elements(), 16));
+    }
+};
+
+struct FloodSink : Pothos::Block
+{
+    FloodSink(void):
+        count(0)
+    {
+        this->setupInput(0, "int32");
+        this->input(0)->setReserve(1);
+        this->registerCall(POTHOS_FCN_TUPLE(FloodSink, getCount));
+    }
+
+    void work(void)
+    {
+        auto in = this->input(0);
+        count += in->elements();
+        in->consume(in->elements());
+    }
+
+    unsigned long long getCount(void) const
+    {
+        return count;
+    }
+
+    unsigned long long count;
+};
+
+POTHOS_TEST_BLOCK("/framework/benchmarks", benchmark_control_latency)
+{
+    const size_t numCalls = 500;
+    std::vector<long long> latencies;
+
+    auto source = std::make_shared<FloodSource>();
+    auto sink = std::make_shared<FloodSink>();
+    {
+        Pothos::Topology topology;
+        topology.connect(source, 0, sink, 0);
+        topology.commit();
+
+        for (size_t i = 0; i < numCalls; i++)
+        {
+            const auto start = latencyNowNs();
+            sink->opaqueCall("getCount", nullptr, 0);
+            latencies.push_back(latencyNowNs() - start);
+        }
+    }
+
+    std::sort(latencies.begin(), latencies.end());
+    const auto p50 = latencies[latencies.size()*50/100];
+    const auto p99 = latencies[latencies.size()*99/100];
+    std::cout << Poco::format("call latency under load: p50 %0.1f us, p99 %0.1f us, %s elements",
+        p50/1e3, p99/1e3, std::to_string(sink->count)) << std::endl;
+}
@@ -0,0 +1,217 @@
+// Copyright (c) 2014-2014 Josh Blum
+// SPDX-License-Identifier: BSL-1.0
+
+#include <Pothos/Testing.hpp>
+#include <Pothos/Framework.hpp>
+#include <Poco/Timestamp.h>
+#include <Poco/Thread.h>
+#include <Poco/Format.h>
+#include <Poco/Environment.h>
+#include <algorithm> //min
+#include <iostream>
+#include <atomic>
+
+/***********************************************************************
+ * Fan-out and fan-in topology:
+ * One source feeds many stateless processors,
+ * and all of the processors feed one sink.
+ **********************************************************************/
+struct BenchmarkSource : Pothos::Block
+{
+    BenchmarkSource(const size_t total):
+        total(total),
+        count(0)
+    {
+        this->setupOutput(0, "float32");
+    }
+
+    void work(void)
+    {
+        auto out = this->output(0);
+        const size_t n = std::min(out->elements(), total-count);
+        auto buff = out->buffer().as<float *>();
+        for (size_t i = 0; i < n; i++) buff[i] = float(i);
+        count += n;
+        out->produce(n);
+    }
+
+    const size_t total;
+    size_t count;
+};
+
+struct BenchmarkProcessor : Pothos::Block
+{
+    BenchmarkProcessor(void)
+    {
+        this->setupInput(0, "float32");
+        this->setupOutput(0, "float32");
+    }
+
+    void work(void)
+    {
+        const size_t n = this->workInfo().minElements;
+        auto in = this->input(0)->buffer().as<const float *>();
+        auto out = this->output(0)->buffer().as<float *>();
+        for (size_t i = 0; i < n; i++)
+        {
+            float x = in[i];
+            for (size_t j = 0; j < 16; j++) x = x*0.5f + 1.0f;
+            out[i] = x;
+        }
+        this->input(0)->consume(n);
+        this->output(0)->produce(n);
+    }
+};
+
+struct BenchmarkSink : Pothos::Block
+{
+    BenchmarkSink(const size_t numInputs):
+        count(0)
+    {
+        for (size_t i = 0; i < numInputs; i++) this->setupInput(i, "float32");
+    }
+
+    void work(void)
+    {
+        for (auto input : this->inputs())
+        {
+            count += input->elements();
+            input->consume(input->elements());
+        }
+    }
+
+    std::atomic<size_t> count;
+};
+
+static double runSchedulerBenchmark(const Pothos::ThreadPoolArgs &args, const size_t numProcessors)
+{
+    const size_t total = 1 << 16; //smoke-test size, the self tests run every benchmark
+    auto source = std::make_shared<BenchmarkSource>(total);
+    auto sink = std::make_shared<BenchmarkSink>(numProcessors);
+    std::vector<std::shared_ptr<BenchmarkProcessor>> processors;
+
+    const Poco::Timestamp startTime;
+    {
+        Pothos::Topology topology;
+        topology.setThreadPoolArgs(args);
+        for (size_t i = 0; i < numProcessors; i++)
+        {
+            processors.emplace_back(new BenchmarkProcessor());
+            topology.connect(source, 0, processors.back(), 0);
+            topology.connect(processors.back(), 0, sink, i);
+        }
+        topology.commit();
+
+        //wait for all elements to arrive at the sink
+        while (sink->count < total*numProcessors and startTime.elapsed() < 10*1000*1000)
+        {
+            Poco::Thread::sleep(1);
+        }
+    }
+
+    POTHOS_TEST_EQUAL(sink->count, total*numProcessors);
+    return (total*numProcessors)/(startTime.elapsed()/1e6);
+}
+
+POTHOS_TEST_BLOCK("/framework/benchmarks", benchmark_work_stealing)
+{
+    Pothos::ThreadPoolArgs stockArgs;
+    Pothos::ThreadPoolArgs stealingArgs;
+    stealingArgs.workStealing = true;
+
+    std::cout << Poco::format("scheduler benchmark on %d processors", int(Poco::Environment::processorCount())) << std::endl;
+    for (size_t numProcessors = 1; numProcessors <= 8; numProcessors *= 2)
+    {
+        const double stockRate = runSchedulerBenchmark(stockArgs, numProcessors);
+        const double stealingRate = runSchedulerBenchmark(stealingArgs, numProcessors);
+        std::cout << Poco::format("  %d processors: shared queue %0.1f Melements/s, work stealing %0.1f Melements/s",
+            int(numProcessors), stockRate/1e6, stealingRate/1e6) << std::endl;
+    }
+}
+
+/***********************************************************************
+ * Linear chain topology:
+ * One source feeds a chain of processors into a single sink,
+ * which is a candidate for fusion into a single execution unit.
+ **********************************************************************/
+static double runChainBenchmark(const bool fusion, const size_t numProcessors)
+{
+    const size_t total = 1 << 16; //includes the fused thread pool setup at this size
+    auto source = std::make_shared<BenchmarkSource>(total);
+    auto sink = std::make_shared<BenchmarkSink>(1);
+    std::vector<std::shared_ptr<BenchmarkProcessor>> processors;
+    for (size_t i = 0; i < numProcessors; i++) processors.emplace_back(new BenchmarkProcessor());
+
+    const Poco::Timestamp startTime;
+    {
+        Pothos::Topology topology;
+        topology.setFusionEnabled(fusion);
+        topology.connect(source, 0, processors.front(), 0);
+        for (size_t i = 1; i < numProcessors; i++) topology.connect(processors[i-1], 0, processors[i], 0);
+        topology.connect(processors.back(), 0, sink, 0);
+        topology.commit();
+
+        //wait for all elements to arrive at the sink
+        while (sink->count < total and startTime.elapsed() < 10*1000*1000)
+        {
+            Poco::Thread::sleep(1);
+        }
+    }
+
+    POTHOS_TEST_EQUAL(sink->count, total);
+    return total/(startTime.elapsed()/1e6);
+}
+
+POTHOS_TEST_BLOCK("/framework/benchmarks", benchmark_fusion)
+{
+    std::cout << "linear chain benchmark" << std::endl;
+    for (size_t numProcessors = 1; numProcessors <= 8; numProcessors *= 2)
+    {
+        const double actorRate = runChainBenchmark(false, numProcessors);
+        const double fusedRate = runChainBenchmark(true, numProcessors);
+        std::cout << Poco::format("  %d processors: separate actors %0.1f Melements/s, fused %0.1f Melements/s",
+            int(numProcessors), actorRate/1e6, fusedRate/1e6) << std::endl;
+    }
+}
+
+/***********************************************************************
+ * Replicated processor:
+ * One source feeds a processor and its replicas into a single sink,
+ * the stream is dealt to the replicas and merged back in order.
+ **********************************************************************/
+static double runReplicaBenchmark(const size_t numReplicas)
+{
+    const size_t total = 1 << 16;
+    auto source = std::make_shared<BenchmarkSource>(total);
+    auto sink = std::make_shared<BenchmarkSink>(1);
+    std::vector<std::shared_ptr<BenchmarkProcessor>> processors;
+    for (size_t i = 0; i < numReplicas; i++) processors.emplace_back(new BenchmarkProcessor());
+
+    const Poco::Timestamp startTime;
+    {
+        Pothos::Topology topology;
+        for (size_t i = 1; i < numReplicas; i++) topology.addReplica(processors.front(), processors[i]);
+        topology.connect(source, 0, processors.front(), 0);
+        topology.connect(processors.front(), 0, sink, 0);
+        topology.commit();
+
+        //wait for all elements to arrive at the sink
+        while (sink->count < total and startTime.elapsed() < 10*1000*1000)
+        {
+            Poco::Thread::sleep(1);
+        }
+    }
+
+    POTHOS_TEST_EQUAL(sink->count, total);
+    return total/(startTime.elapsed()/1e6);
+}
+
+POTHOS_TEST_BLOCK("/framework/benchmarks", benchmark_replicas)
+{
+    std::cout << Poco::format("replica benchmark on %d processors", int(Poco::Environment::processorCount())) << std::endl;
+    for (size_t numReplicas = 1; numReplicas <= 8; numReplicas *= 2)
+    {
+        const double rate = runReplicaBenchmark(numReplicas);
+        std::cout << Poco::format("  %d replicas: %0.1f Melements/s", int(numReplicas), rate/1e6) << std::endl;
+    }
+}
@@ -0,0 +1,96 @@
+// Copyright (c) 2014-2014 Josh Blum
+// SPDX-License-Identifier: BSL-1.0
+
+#include <Pothos/Testing.hpp>
+#include <Pothos/Framework/SharedBuffer.hpp>
+#include <Poco/Timestamp.h>
+#include <Poco/Format.h>
+#include <iostream>
+#include <cstring> //memset
+#include <vector>
+#include <thread>
+
+/***********************************************************************
+ * Scattered accesses across a large buffer:
+ * Each access likely lands on a different page,
+ * so the access time is dominated by TLB misses,
+ * which huge pages reduce by covering more memory per entry.
+ **********************************************************************/
+static double runAccessBenchmark(const Pothos::SharedBuffer &buffer)
+{
+    const size_t numAccesses = 256*1024;
+    const size_t numWords = buffer.getLength()/sizeof(size_t); //power of two
+    auto words = reinterpret_cast<size_t *>(buffer.getAddress());
+
+    //touch every page before measuring
+    std::memset(words, 0, buffer.getLength());
+
+    const Poco::Timestamp startTime;
+    size_t index = 0;
+    for (size_t i = 0; i < numAccesses; i++)
+    {
+        //linear congruential steps make a scattered access pattern
+        index = (index*6364136223846793005ull + 1442695040888963407ull) & (numWords-1);
+        words[index] += i;
+    }
+    const Poco::Timestamp::TimeDiff elapsed = startTime.elapsed();
+    return (elapsed*1e3)/numAccesses;
+}
+
+POTHOS_TEST_BLOCK("/framework/benchmarks", benchmark_huge_pages)
+{
+    //a few huge pages, past the caches but small enough for the self tests
+    const size_t numBytes = 8*1024*1024;
+    std::cout << Poco::format("scattered accesses over a %z MiB buffer", numBytes >> 20) << std::endl;
+    const double nsGeneric = runAccessBenchmark(Pothos::SharedBuffer::make(numBytes));
+    std::cout << Poco::format("  generic pages: %0.1f ns per access", nsGeneric) << std::endl;
+    const double nsHuge = runAccessBenchmark(Pothos::SharedBuffer::makeHuge(numBytes));
+    std::cout << Poco::format("  huge pages: %0.1f ns per access", nsHuge) << std::endl;
+}
+
+/***********************************************************************
+ * Allocate and release small buffers:
+ * Batches of allocations show the cost of the slab pool,
+ * once freed on the same thread and once freed by another thread,
+ * compared to a new[] with a shared_ptr control block per buffer.
+ * The cross thread numbers include the cost of starting the thread.
+ **********************************************************************/
+template <typename MakeFcn>
+static double runAllocBenchmark(const MakeFcn &makeFcn, const bool crossThread)
+{
+    const size_t numBatches = 200;
+    const size_t batchSize = 256;
+    std::vector<Pothos::SharedBuffer> batch;
+
+    const Poco::Timestamp startTime;
+    for (size_t i = 0; i < numBatches; i++)
+    {
+        for (size_t j = 0; j < batchSize; j++) batch.push_back(makeFcn());
+        if (crossThread) std::thread([&batch](void){batch.clear();}).join();
+        else batch.clear();
+    }
+    const Poco::Timestamp::TimeDiff elapsed = startTime.elapsed();
+    return (elapsed*1e3)/(numBatches*batchSize);
+}
+
+POTHOS_TEST_BLOCK("/framework/benchmarks", benchmark_small_allocations)
+{
+    std::cout << "allocate and release small buffers" << std::endl;
+    for (const size_t numBytes : {64, 1500, 8192, 65536})
+    {
+        const auto makeNew = [numBytes](void)
+        {
+            std::shared_ptr<char> mem(new char[numBytes], std::default_delete<char[]>());
+            return Pothos::SharedBuffer(size_t(mem.get()), numBytes, mem);
+        };
+        const auto makeSlab = [numBytes](void)
+        {
+            return Pothos::SharedBuffer::make(numBytes);
+        };
+        const double nsNew = runAllocBenchmark(makeNew, false);
+        const double nsSlab = runAllocBenchmark(makeSlab, false);
+        const double nsCross = runAllocBenchmark(makeSlab, true);
+        std::cout << Poco::format("  %z bytes: new[] %0.1f ns, slab %0.1f ns, slab freed by other thread %0.1f ns",
+            numBytes, nsNew, nsSlab, nsCross) << std::endl;
+    }
+}
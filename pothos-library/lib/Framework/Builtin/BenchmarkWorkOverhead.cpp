@@ -0,0 +1,81 @@
+// Copyright (c) 2014-2014 Josh Blum
+// SPDX-License-Identifier: BSL-1.0
+
+#include <Pothos/Testing.hpp>
+#include <Pothos/Framework.hpp>
+#include <Poco/Timestamp.h>
+#include <Poco/Thread.h>
+#include <Poco/Format.h>
+#include <iostream>
+#include <atomic>
+
+/***********************************************************************
+ * Many-port blocks that do minimal work:
+ * The source produces one element on every output,
+ * and the sink consumes everything on every input,
+ * so the work call rate is dominated by the per-port bookkeeping.
+ **********************************************************************/
+struct OverheadSource : Pothos::Block
+{
+    OverheadSource(const size_t numPorts):
+        numWorkCalls(0)
+    {
+        for (size_t i = 0; i < numPorts; i++) this->setupOutput(i, "float32");
+    }
+
+    void work(void)
+    {
+        numWorkCalls++;
+        for (auto output : this->outputs()) output->produce(1);
+    }
+
+    std::atomic<unsigned long long> numWorkCalls;
+};
+
+struct OverheadSink : Pothos::Block
+{
+    OverheadSink(const size_t numPorts)
+    {
+        for (size_t i = 0; i < numPorts; i++) this->setupInput(i, "float32");
+    }
+
+    void work(void)
+    {
+        for (auto input : this->inputs()) input->consume(input->elements());
+    }
+};
+
+static double runOverheadBenchmark(const size_t numPorts)
+{
+    auto source = std::make_shared<OverheadSource>(numPorts);
+    auto sink = std::make_shared<OverheadSink>(numPorts);
+
+    Pothos::Topology topology;
+    for (size_t i = 0; i < numPorts; i++)
+    {
+        topology.connect(source, i, sink, i);
+    }
+    topology.commit();
+
+    //let the topology settle before measuring
+    Poco::Thread::sleep(100);
+    const unsigned long long startCalls = source->numWorkCalls;
+    const Poco::Timestamp startTime;
+    Poco::Thread::sleep(500);
+    const unsigned long long numCalls = source->numWorkCalls - startCalls;
+    const Poco::Timestamp::TimeDiff elapsed = startTime.elapsed();
+
+    POTHOS_TEST_TRUE(numCalls > 0);
+    return (elapsed*1e3)/numCalls;
+}
+
+POTHOS_TEST_BLOCK("/framework/benchmarks", benchmark_work_overhead)
+{
+    std::cout << "work call overhead per port count" << std::endl;
+    for (size_t numPorts = 1; numPorts <= 64; numPorts *= 4)
+    {
+        const double nsPerCall = runOverheadBenchmark(numPorts);
+        std::cout << Poco::format("  %d ports: %0.1f ns per work call, %0.1f ns per port",
+            int(numPorts), nsPerCall, nsPerCall/numPorts) << std::endl;
+    }
+}
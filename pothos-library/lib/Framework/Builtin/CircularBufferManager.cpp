@@ -51,6 +51,11 @@ public:
         return _readyBuffs.empty();
     }
 
+    size_t numReady(void) const
+    {
+        return _readyBuffs.size();
+    }
+
     const Pothos::ManagedBuffer &front(void) const
     {
         assert(not _readyBuffs.empty());
@@ -22,10 +22,17 @@ public:
     void init(const Pothos::BufferManagerArgs &args)
     {
         _readyBuffs.set_capacity(args.numBuffers);
+
+        //one huge page slab holds all of the buffers
+        Pothos::SharedBuffer slab;
+        if (args.hugePages) slab = Pothos::SharedBuffer::makeHuge(
+            args.bufferSize*args.numBuffers, args.nodeAffinity);
+
         for (size_t i = 0; i < args.numBuffers; i++)
         {
-            auto sharedBuff = Pothos::SharedBuffer::make(
-                args.bufferSize, args.nodeAffinity);
+            auto sharedBuff = args.hugePages?
+                Pothos::SharedBuffer(slab.getAddress() + i*args.bufferSize, args.bufferSize, slab):
+                Pothos::SharedBuffer::make(args.bufferSize, args.nodeAffinity);
             Pothos::ManagedBuffer buffer;
             buffer.reset(this->shared_from_this(), sharedBuff);
         }
@@ -36,6 +43,11 @@ public:
         return _readyBuffs.empty();
     }
 
+    size_t numReady(void) const
+    {
+        return _readyBuffs.size();
+    }
+
     const Pothos::ManagedBuffer &front(void) const
     {
         assert(not _readyBuffs.empty());
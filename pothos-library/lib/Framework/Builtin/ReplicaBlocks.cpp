@@ -0,0 +1,201 @@
+// Copyright (c) 2014-2014 Josh Blum
+// SPDX-License-Identifier: BSL-1.0
+
+#include <Pothos/Framework.hpp>
+#include <algorithm> //min
+#include <vector>
+
+/***********************************************************************
+ * Forward the labels within a region of the input stream:
+ * Labels in [begin, begin+n) are posted to the output at the same
+ * offset past outBegin. The label iterator advances past the region.
+ **********************************************************************/
+static void forwardReplicaLabels(
+    Pothos::LabelIteratorRange::const_iterator &it,
+    const Pothos::LabelIteratorRange::const_iterator &end,
+    const unsigned long long begin, const size_t n,
+    Pothos::OutputPort *output, const unsigned long long outBegin)
+{
+    for (; it != end and it->index < begin+n; ++it)
+    {
+        auto label = *it;
+        //labels which arrived late are placed at the start of the region
+        label.index = outBegin + ((label.index > begin)? label.index-begin : 0);
+        output->postLabel(label);
+    }
+}
+
+/***********************************************************************
+ * |PothosDoc Replica Splitter
+ *
+ * The replica splitter deals the input stream to its outputs
+ * in round-robin chunks of a fixed number of elements.
+ * The chunks are forwarded without copying, and labels are moved
+ * to the output that receives the chunk, at the same offset.
+ * Async messages go to the output of the current chunk.
+ * Topology::commit() inserts this block in front of a replicated block.
+ *
+ * |category /Misc
+ * |keywords replica split parallel
+ *
+ * |param dtype[Data Type] The datatype this block consumes.
+ * |param numOutputs[Num Outputs] The number of replicas to feed.
+ * |param chunkElements[Chunk Elements] The elements dealt to each replica in turn.
+ *
+ * |factory /blocks/framework/replica_splitter(dtype, numOutputs, chunkElements)
+ **********************************************************************/
+class ReplicaSplitter : public Pothos::Block
+{
+public:
+    static Block *make(const Pothos::DType &dtype, const size_t numOutputs, const size_t chunkElements)
+    {
+        return new ReplicaSplitter(dtype, numOutputs, chunkElements);
+    }
+
+    ReplicaSplitter(const Pothos::DType &dtype, const size_t numOutputs, const size_t chunkElements):
+        _chunkElements(std::max<size_t>(chunkElements, 1)),
+        _next(0),
+        _remaining(_chunkElements)
+    {
+        this->setupInput(0, dtype);
+        for (size_t i = 0; i < numOutputs; i++) this->setupOutput(i, dtype);
+    }
+
+    void work(void)
+    {
+        auto in = this->input(0);
+        const auto &outputs = this->outputs();
+        while (in->hasMessage()) outputs[_next]->postMessage(in->popMessage());
+
+        const size_t available = in->elements();
+        if (available == 0) return;
+
+        //output totals do not include the buffers posted during this call
+        std::vector<unsigned long long> posted(outputs.size(), 0);
+        auto labelIt = in->labels().begin();
+        const auto labelEnd = in->labels().end();
+        const size_t elemSize = in->dtype().size();
+
+        size_t offset = 0;
+        while (offset < available)
+        {
+            auto output = outputs[_next];
+            const size_t n = std::min(available-offset, _remaining);
+
+            auto chunk = in->buffer();
+            chunk.address += offset*elemSize;
+            chunk.length = n*elemSize;
+            forwardReplicaLabels(labelIt, labelEnd, in->totalElements()+offset, n,
+                output, output->totalElements()+posted[_next]);
+            output->postBuffer(chunk);
+            posted[_next] += n;
+
+            offset += n;
+            _remaining -= n;
+            if (_remaining == 0)
+            {
+                _next = (_next+1) % outputs.size();
+                _remaining = _chunkElements;
+            }
+        }
+        in->consume(available);
+    }
+
+    void propagateLabels(const Pothos::InputPort *, const Pothos::LabelIteratorRange &)
+    {
+        return; //labels were forwarded in work()
+    }
+
+private:
+    const size_t _chunkElements;
+    size_t _next;
+    size_t _remaining;
+};
+
+static Pothos::BlockRegistry registerReplicaSplitter(
+    "/blocks/framework/replica_splitter", &ReplicaSplitter::make);
+
+/***********************************************************************
+ * |PothosDoc Replica Merger
+ *
+ * The replica merger restores the order of a stream that was dealt
+ * to replicas by the replica splitter. It reads the same chunks from
+ * its inputs in round-robin order, so every replica must produce
+ * one output element for every input element that it consumes.
+ * The chunks are forwarded without copying, and labels are moved
+ * to the output at the same offset within the chunk.
+ * Async messages from all inputs are forwarded to the output.
+ * Topology::commit() inserts this block behind a replicated block.
+ *
+ * |category /Misc
+ * |keywords replica merge parallel
+ *
+ * |param dtype[Data Type] The datatype this block produces.
+ * |param numInputs[Num Inputs] The number of replicas to collect.
+ * |param chunkElements[Chunk Elements] The elements taken from each replica in turn.
+ *
+ * |factory /blocks/framework/replica_merger(dtype, numInputs, chunkElements)
+ **********************************************************************/
+class ReplicaMerger : public Pothos::Block
+{
+public:
+    static Block *make(const Pothos::DType &dtype, const size_t numInputs, const size_t chunkElements)
+    {
+        return new ReplicaMerger(dtype, numInputs, chunkElements);
+    }
+
+    ReplicaMerger(const Pothos::DType &dtype, const size_t numInputs, const size_t chunkElements):
+        _chunkElements(std::max<size_t>(chunkElements, 1)),
+        _next(0),
+        _remaining(_chunkElements)
+    {
+        for (size_t i = 0; i < numInputs; i++) this->setupInput(i, dtype);
+        this->setupOutput(0, dtype);
+    }
+
+    void work(void)
+    {
+        auto out = this->output(0);
+        const auto &inputs = this->inputs();
+        for (auto in : inputs)
+        {
+            while (in->hasMessage()) out->postMessage(in->popMessage());
+        }
+
+        //visit each input at most once, a chunk may span several calls
+        unsigned long long posted = 0;
+        for (size_t i = 0; i < inputs.size(); i++)
+        {
+            auto in = inputs[_next];
+            const size_t n = std::min(in->elements(), _remaining);
+            if (n == 0) return;
+
+            auto chunk = in->buffer();
+            chunk.length = n*in->dtype().size();
+            auto labelIt = in->labels().begin();
+            forwardReplicaLabels(labelIt, in->labels().end(), in->totalElements(), n,
+                out, out->totalElements()+posted);
+            out->postBuffer(chunk);
+            in->consume(n);
+            posted += n;
+
+            _remaining -= n;
+            if (_remaining != 0) return;
+            _next = (_next+1) % inputs.size();
+            _remaining = _chunkElements;
+        }
+    }
+
+    void propagateLabels(const Pothos::InputPort *, const Pothos::LabelIteratorRange &)
+    {
+        return; //labels were forwarded in work()
+    }
+
+private:
+    const size_t _chunkElements;
+    size_t _next;
+    size_t _remaining;
+};
+
+static Pothos::BlockRegistry registerReplicaMerger(
+    "/blocks/framework/replica_merger", &ReplicaMerger::make);
@@ -0,0 +1,51 @@
+// Copyright (c) 2014-2014 Josh Blum
+// SPDX-License-Identifier: BSL-1.0
+
+#include <Pothos/Testing.hpp>
+#include <Pothos/Framework/BufferAccumulator.hpp>
+#include <Pothos/Framework/BufferChunk.hpp>
+
+static Pothos::BufferChunk makeCountingChunk(const size_t numInts, const int start)
+{
+    Pothos::BufferChunk chunk(Pothos::SharedBuffer::make(numInts*sizeof(int)));
+    for (size_t i = 0; i < numInts; i++) chunk.as<int *>()[i] = start+int(i);
+    return chunk;
+}
+
+POTHOS_TEST_BLOCK("/framework/tests", test_buffer_accumulator_pool)
+{
+    Pothos::BufferAccumulator accumulator;
+    const size_t numInts = 1000;
+
+    for (size_t iter = 0; iter < 3; iter++)
+    {
+        //two separate buffers require a copy into a pooled buffer
+        accumulator.push(makeCountingChunk(numInts, 0));
+        accumulator.push(makeCountingChunk(numInts, numInts));
+        accumulator.require(numInts*2*sizeof(int));
+        const auto &front = accumulator.front();
+        POTHOS_TEST_TRUE(front.length >= numInts*2*sizeof(int));
+        for (size_t i = 0; i < numInts*2; i++)
+        {
+            POTHOS_TEST_EQUAL(front.as<const int *>()[i], int(i));
+        }
+        accumulator.pop(numInts*2*sizeof(int));
+        POTHOS_TEST_TRUE(accumulator.empty());
+    }
+
+    //only the first copy allocates, the others reuse it
+    POTHOS_TEST_EQUAL(accumulator.getPoolMisses(), 1);
+    POTHOS_TEST_EQUAL(accumulator.getPoolHits(), 2);
+
+    //a larger size class does not disturb the smaller one
+    accumulator.push(makeCountingChunk(numInts*4, 0));
+    accumulator.push(makeCountingChunk(numInts*4, numInts*4));
+    accumulator.require(numInts*8*sizeof(int));
+    accumulator.pop(numInts*8*sizeof(int));
+    POTHOS_TEST_EQUAL(accumulator.getPoolMisses(), 2);
+    accumulator.push(makeCountingChunk(numInts, 0));
+    accumulator.push(makeCountingChunk(numInts, numInts));
+    accumulator.require(numInts*2*sizeof(int));
+    accumulator.pop(numInts*2*sizeof(int));
+    POTHOS_TEST_EQUAL(accumulator.getPoolHits(), 3);
+}
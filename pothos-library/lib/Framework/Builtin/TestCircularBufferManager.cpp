@@ -5,6 +5,8 @@
 #include <Pothos/Framework/BufferManager.hpp>
 #include <Pothos/Framework/BufferChunk.hpp>
 #include <Pothos/Framework/Exception.hpp>
+#include <Pothos/Framework.hpp>
+#include <algorithm> //min
 
 POTHOS_TEST_BLOCK("/framework/tests", test_circular_buffer_manager)
 {
@@ -43,3 +45,73 @@ POTHOS_TEST_BLOCK("/framework/tests", test_circular_buffer_manager)
         manager->pop(buff.getBuffer().getLength());
     }
 }
+
+struct ReserveTestSource : Pothos::Block
+{
+    ReserveTestSource(const size_t total):
+        total(total),
+        count(0)
+    {
+        this->setupOutput(0, "int32");
+    }
+
+    void work(void)
+    {
+        auto out = this->output(0);
+        const size_t n = std::min(out->elements(), total-count);
+        auto buff = out->buffer().as<int *>();
+        for (size_t i = 0; i < n; i++) buff[i] = int(count++);
+        out->produce(n);
+    }
+
+    const size_t total;
+    size_t count;
+};
+
+struct ReserveTestSink : Pothos::Block
+{
+    ReserveTestSink(const size_t reserve):
+        reserve(reserve),
+        count(0),
+        errors(0),
+        circular(true)
+    {
+        this->setupInput(0, "int32");
+        this->input(0)->setReserve(reserve);
+    }
+
+    void work(void)
+    {
+        auto in = this->input(0);
+        if (in->buffer().getAlias() == 0) circular = false;
+        auto buff = in->buffer().as<const int *>();
+        for (size_t i = 0; i < reserve; i++)
+        {
+            if (buff[i] != int(count++)) errors++;
+        }
+        in->consume(reserve);
+    }
+
+    const size_t reserve;
+    size_t count;
+    size_t errors;
+    bool circular;
+};
+
+POTHOS_TEST_BLOCK("/framework/tests", test_circular_buffer_negotiation)
+{
+    //the reserve straddles the default buffer size
+    const size_t reserve = 3000;
+    const size_t total = reserve*40;
+    auto source = std::make_shared<ReserveTestSource>(total);
+    auto sink = std::make_shared<ReserveTestSink>(reserve);
+    {
+        Pothos::Topology topology;
+        topology.connect(source, 0, sink, 0);
+        topology.commit();
+        POTHOS_TEST_TRUE(topology.waitInactive(0.1, 10.0));
+    }
+    POTHOS_TEST_EQUAL(sink->count, total);
+    POTHOS_TEST_EQUAL(sink->errors, 0);
+    POTHOS_TEST_TRUE(sink->circular);
+}
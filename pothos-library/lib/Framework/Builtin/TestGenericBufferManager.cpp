@@ -5,6 +5,7 @@
 #include <Pothos/Framework/BufferManager.hpp>
 #include <Pothos/Framework/BufferChunk.hpp>
 #include <Pothos/Framework/Exception.hpp>
+#include <vector>
 
 POTHOS_TEST_BLOCK("/framework/tests", test_generic_buffer_manager)
 {
@@ -24,3 +25,139 @@ POTHOS_TEST_BLOCK("/framework/tests", test_generic_buffer_manager)
     buffs.clear();
     POTHOS_TEST_TRUE(not manager->empty());
 }
+
+POTHOS_TEST_BLOCK("/framework/tests", test_buffer_manager_push_external)
+{
+    Pothos::BufferManagerArgs args;
+    args.numBuffers = 2;
+    auto manager = Pothos::BufferManager::make("generic", args);
+    size_t numWakeups = 0;
+    manager->setCallback([&numWakeups](void){numWakeups++;});
+
+    std::vector<Pothos::BufferChunk> buffs(2);
+    buffs[0] = manager->front();
+    manager->pop(buffs[0].length);
+    buffs[1] = manager->front();
+    manager->pop(buffs[1].length);
+
+    //the manager is not starved yet, returned buffers wait in the queue
+    buffs[0] = Pothos::BufferChunk();
+    POTHOS_TEST_EQUAL(numWakeups, 0);
+    POTHOS_TEST_TRUE(manager->empty());
+    manager->flushExternal();
+    POTHOS_TEST_TRUE(not manager->empty());
+
+    //starve the manager, only the first return wakes the owner
+    buffs[0] = manager->front();
+    manager->pop(buffs[0].length);
+    manager->flushExternal();
+    POTHOS_TEST_TRUE(manager->empty());
+    buffs.clear();
+    POTHOS_TEST_EQUAL(numWakeups, 1);
+    manager->flushExternal();
+    POTHOS_TEST_TRUE(not manager->empty());
+}
+
+/***********************************************************************
+ * A manager that hands out more buffers than its return queue holds
+ **********************************************************************/
+class ExtraBufferManager :
+    public Pothos::BufferManager,
+    public std::enable_shared_from_this<ExtraBufferManager>
+{
+public:
+    //the return queue keeps its default capacity, below numBuffers
+    static std::shared_ptr<ExtraBufferManager> make(const Pothos::BufferManagerArgs &args)
+    {
+        auto manager = std::make_shared<ExtraBufferManager>();
+        manager->init(args);
+        return manager;
+    }
+
+    bool empty(void) const
+    {
+        return _readyBuffs.empty();
+    }
+
+    const Pothos::ManagedBuffer &front(void) const
+    {
+        return _readyBuffs.front();
+    }
+
+    void pop(const size_t /*numBytes*/)
+    {
+        _readyBuffs.erase(_readyBuffs.begin());
+    }
+
+    void push(const Pothos::ManagedBuffer &buff)
+    {
+        _readyBuffs.push_back(buff);
+    }
+
+protected:
+    void init(const Pothos::BufferManagerArgs &args)
+    {
+        for (size_t i = 0; i < args.numBuffers; i++)
+        {
+            Pothos::ManagedBuffer buffer;
+            buffer.reset(this->shared_from_this(), Pothos::SharedBuffer::make(args.bufferSize));
+        }
+    }
+
+private:
+    std::vector<Pothos::ManagedBuffer> _readyBuffs;
+};
+
+POTHOS_TEST_BLOCK("/framework/tests", test_buffer_manager_push_external_overflow)
+{
+    Pothos::BufferManagerArgs args;
+    args.numBuffers = 8;
+    auto manager = ExtraBufferManager::make(args);
+    size_t numWakeups = 0;
+    manager->setCallback([&numWakeups](void){numWakeups++;});
+
+    std::vector<Pothos::BufferChunk> buffs;
+    while (not manager->empty())
+    {
+        buffs.push_back(manager->front());
+        manager->pop(buffs.back().length);
+    }
+    POTHOS_TEST_EQUAL(buffs.size(), args.numBuffers);
+    manager->flushExternal();
+
+    //returning every buffer from the owner thread overflows the queue
+    buffs.clear();
+    POTHOS_TEST_EQUAL(numWakeups, 1);
+    manager->flushExternal();
+    while (not manager->empty())
+    {
+        buffs.push_back(manager->front());
+        manager->pop(buffs.back().length);
+    }
+    POTHOS_TEST_EQUAL(buffs.size(), args.numBuffers);
+}
+
+POTHOS_TEST_BLOCK("/framework/tests", test_generic_buffer_manager_huge_pages)
+{
+    Pothos::BufferManagerArgs args;
+    args.numBuffers = 4;
+    args.hugePages = true;
+    auto manager = Pothos::BufferManager::make("generic", args);
+
+    //the buffers are carved from one slab
+    std::vector<Pothos::BufferChunk> buffs;
+    while (not manager->empty())
+    {
+        buffs.push_back(manager->front());
+        manager->pop(buffs.back().length);
+    }
+    POTHOS_TEST_EQUAL(buffs.size(), args.numBuffers);
+    for (size_t i = 1; i < buffs.size(); i++)
+    {
+        POTHOS_TEST_EQUAL(buffs[i].length, args.bufferSize);
+        POTHOS_TEST_EQUAL(buffs[i].address, buffs[0].address + i*args.bufferSize);
+    }
+
+    buffs.clear();
+    POTHOS_TEST_TRUE(not manager->empty());
+}
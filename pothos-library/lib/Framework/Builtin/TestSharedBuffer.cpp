@@ -5,6 +5,8 @@
 #include <Pothos/Framework/SharedBuffer.hpp>
 #include <Pothos/Framework/Exception.hpp>
 #include <cstdlib> //rand
+#include <vector>
+#include <thread>
 
 POTHOS_TEST_BLOCK("/framework/tests", test_generic_shared_buffer)
 {
@@ -38,6 +40,38 @@ POTHOS_TEST_BLOCK("/framework/tests", test_generic_shared_buffer)
     auto b2 = Pothos::SharedBuffer(b1.getAddress() + 512, b1.getLength() - 512, b1);
 }
 
+POTHOS_TEST_BLOCK("/framework/tests", test_slab_shared_buffer)
+{
+    //a freed buffer is recycled for the next allocation in its size class
+    auto b0 = Pothos::SharedBuffer::make(100);
+    POTHOS_TEST_TRUE((b0.getAddress() & 0x3f) == 0); //has alignment
+    POTHOS_TEST_EQUAL(b0.getLength(), 100);
+    POTHOS_TEST_TRUE(b0.unique());
+    const size_t address = b0.getAddress();
+    b0 = Pothos::SharedBuffer();
+    auto b1 = Pothos::SharedBuffer::make(120);
+    POTHOS_TEST_EQUAL(b1.getAddress(), address);
+    POTHOS_TEST_EQUAL(b1.getLength(), 120);
+
+    //buffers freed on another thread return through the depot
+    std::vector<Pothos::SharedBuffer> buffs;
+    for (size_t i = 0; i < 1000; i++) buffs.push_back(Pothos::SharedBuffer::make(1500));
+    std::thread([&buffs](void){buffs.clear();}).join();
+    for (size_t i = 0; i < 1000; i++)
+    {
+        buffs.push_back(Pothos::SharedBuffer::make(1500));
+        int *p = reinterpret_cast<int *>(buffs.back().getAddress());
+        p[0] = int(i);
+        p[1500/sizeof(int)-1] = int(i);
+    }
+    for (size_t i = 0; i < 1000; i++)
+    {
+        int *p = reinterpret_cast<int *>(buffs[i].getAddress());
+        POTHOS_TEST_EQUAL(p[0], int(i));
+        POTHOS_TEST_EQUAL(p[1500/sizeof(int)-1], int(i));
+    }
+}
+
 POTHOS_TEST_BLOCK("/framework/tests", test_circular_shared_buffer)
 {
     auto b0 = Pothos::SharedBuffer::makeCirc(1024);
@@ -55,3 +89,29 @@ POTHOS_TEST_BLOCK("/framework/tests", test_circular_shared_buffer)
         POTHOS_TEST_EQUAL(p[i+alias], randNum);
     }
 }
+
+POTHOS_TEST_BLOCK("/framework/tests", test_huge_shared_buffer)
+{
+    const size_t numBytes = 3*1024*1024;
+    auto b0 = Pothos::SharedBuffer::makeHuge(numBytes);
+    POTHOS_TEST_TRUE(b0.getAddress() != 0);
+    POTHOS_TEST_TRUE((b0.getAddress() & 0xf) == 0); //has alignment
+    POTHOS_TEST_TRUE(b0.getLength() >= numBytes);
+    int *p = reinterpret_cast<int *>(b0.getAddress());
+    for (size_t i = 0; i < b0.getLength()/sizeof(int); i++) p[i] = int(i);
+    for (size_t i = 0; i < b0.getLength()/sizeof(int); i++) POTHOS_TEST_EQUAL(p[i], int(i));
+}
+
+POTHOS_TEST_BLOCK("/framework/tests", test_many_circular_shared_buffers)
+{
+    //more live buffers than a typical descriptor limit:
+    //the mappings must not hold onto a file descriptor each
+    std::vector<Pothos::SharedBuffer> buffs;
+    for (size_t i = 0; i < 2048; i++)
+    {
+        buffs.push_back(Pothos::SharedBuffer::makeCirc(4096, 0/*node*/));
+        auto p = reinterpret_cast<int *>(buffs.back().getAddress());
+        p[0] = int(i);
+        POTHOS_TEST_EQUAL(p[buffs.back().getLength()/sizeof(int)], int(i));
+    }
+}
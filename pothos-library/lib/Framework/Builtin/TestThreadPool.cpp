@@ -0,0 +1,674 @@
+// Copyright (c) 2014-2014 Josh Blum
+// SPDX-License-Identifier: BSL-1.0
+
+#include <Pothos/Testing.hpp>
+#include <Pothos/Framework.hpp>
+#include <Poco/Environment.h>
+#include <algorithm> //min
+#include <iterator> //distance
+#include <iostream>
+#include <cstring> //memcpy
+
+struct ThreadPoolTestSource : Pothos::Block
+{
+    ThreadPoolTestSource(const size_t total):
+        total(total),
+        count(0)
+    {
+        this->setupOutput(0, "int32");
+    }
+
+    void work(void)
+    {
+        auto out = this->output(0);
+        const size_t n = std::min(out->elements(), total-count);
+        auto buff = out->buffer().as<int *>();
+        for (size_t i = 0; i < n; i++) buff[i] = int(count++);
+        out->produce(n);
+    }
+
+    const size_t total;
+    size_t count;
+};
+
+struct ThreadPoolTestSink : Pothos::Block
+{
+    ThreadPoolTestSink(void):
+        count(0),
+        errors(0)
+    {
+        this->setupInput(0, "int32");
+    }
+
+    void work(void)
+    {
+        auto in = this->input(0);
+        auto buff = in->buffer().as<const int *>();
+        for (size_t i = 0; i < in->elements(); i++)
+        {
+            if (buff[i] != int(count++)) errors++;
+        }
+        in->consume(in->elements());
+    }
+
+    size_t count;
+    size_t errors;
+};
+
+static void runThreadPoolTopology(const Pothos::ThreadPoolArgs &args, const size_t numChains)
+{
+    const size_t total = 100000;
+    std::vector<std::shared_ptr<ThreadPoolTestSource>> sources;
+    std::vector<std::shared_ptr<ThreadPoolTestSink>> sinks;
+
+    {
+        Pothos::Topology topology;
+        topology.setThreadPoolArgs(args);
+        for (size_t i = 0; i < numChains; i++)
+        {
+            sources.emplace_back(new ThreadPoolTestSource(total));
+            sinks.emplace_back(new ThreadPoolTestSink());
+            topology.connect(sources.back(), 0, sinks.back(), 0);
+        }
+        topology.commit();
+        POTHOS_TEST_TRUE(topology.waitInactive(0.1, 10.0));
+    }
+
+    //all chains ran in the same thread pool
+    for (size_t i = 0; i < numChains; i++)
+    {
+        POTHOS_TEST_TRUE(sources[i]->getThreadPool() == sources[0]->getThreadPool());
+        POTHOS_TEST_TRUE(sinks[i]->getThreadPool() == sources[0]->getThreadPool());
+        POTHOS_TEST_EQUAL(sinks[i]->count, total);
+        POTHOS_TEST_EQUAL(sinks[i]->errors, 0);
+    }
+}
+
+POTHOS_TEST_BLOCK("/framework/tests", test_thread_pool)
+{
+    //blocks share the default thread pool
+    {
+        ThreadPoolTestSource source(0);
+        ThreadPoolTestSink sink;
+        POTHOS_TEST_TRUE(not source.getThreadPool().null());
+        POTHOS_TEST_TRUE(source.getThreadPool() == Pothos::ThreadPool::getDefault());
+        POTHOS_TEST_TRUE(sink.getThreadPool() == source.getThreadPool());
+    }
+
+    //shared pool with fewer threads than blocks
+    std::cout << "shared thread pool" << std::endl;
+    runThreadPoolTopology(Pothos::ThreadPoolArgs(2), 8);
+
+    //work stealing scheduler
+    std::cout << "work stealing" << std::endl;
+    Pothos::ThreadPoolArgs workStealing(2);
+    workStealing.workStealing = true;
+    runThreadPoolTopology(workStealing, 8);
+
+    //polling worker threads
+    std::cout << "backoff yield mode" << std::endl;
+    Pothos::ThreadPoolArgs backoff(2);
+    backoff.yieldMode = "BACKOFF";
+    runThreadPoolTopology(backoff, 4);
+
+    std::cout << "tuned backoff yield mode" << std::endl;
+    Pothos::ThreadPoolArgs tunedBackoff(2);
+    tunedBackoff.yieldMode = "BACKOFF";
+    tunedBackoff.backoffSpinCount = 0;
+    tunedBackoff.backoffYieldCount = 5;
+    tunedBackoff.backoffSleepMs = 2;
+    runThreadPoolTopology(tunedBackoff, 4);
+
+    Pothos::ThreadPoolArgs badBackoff(1);
+    badBackoff.yieldMode = "BACKOFF";
+    badBackoff.backoffSleepMs = 1000;
+    POTHOS_TEST_THROWS(Pothos::ThreadPool pool(badBackoff), Pothos::ThreadPoolError);
+
+    Pothos::ThreadPoolArgs badYield(1);
+    badYield.yieldMode = "FOO";
+    POTHOS_TEST_THROWS(Pothos::ThreadPool pool(badYield), Pothos::ThreadPoolError);
+
+    //one thread per block mode
+    std::cout << "thread per block" << std::endl;
+    Pothos::ThreadPoolArgs threadPerBlock;
+    threadPerBlock.threadPerBlock = true;
+    runThreadPoolTopology(threadPerBlock, 4);
+
+    //cant change the thread pool of a connected block
+    {
+        auto source = std::make_shared<ThreadPoolTestSource>(0);
+        auto sink = std::make_shared<ThreadPoolTestSink>();
+        Pothos::Topology topology;
+        topology.connect(source, 0, sink, 0);
+        topology.commit();
+        POTHOS_TEST_THROWS(source->setThreadPool(Pothos::ThreadPool(Pothos::ThreadPoolArgs(1))), Pothos::ThreadPoolError);
+        topology.disconnectAll();
+        topology.commit();
+        source->setThreadPool(Pothos::ThreadPool(Pothos::ThreadPoolArgs(1)));
+        POTHOS_TEST_EQUAL(source->getThreadPool().getArgs().numThreads, 1);
+    }
+}
+
+POTHOS_TEST_BLOCK("/framework/tests", test_thread_pool_affinity)
+{
+    //validate the affinity args
+    Pothos::ThreadPoolArgs badMode(1);
+    badMode.affinityMode = "FOO";
+    badMode.affinity.push_back(0);
+    POTHOS_TEST_THROWS(Pothos::ThreadPool pool(badMode), Pothos::ThreadPoolError);
+
+    Pothos::ThreadPoolArgs emptyAffinity(1);
+    emptyAffinity.affinityMode = "CPU";
+    POTHOS_TEST_THROWS(Pothos::ThreadPool pool(emptyAffinity), Pothos::ThreadPoolError);
+
+    //a pool on a single NUMA node reports the node affinity
+    Pothos::ThreadPoolArgs numaArgs(1);
+    numaArgs.affinityMode = "NUMA";
+    numaArgs.affinity.push_back(0);
+    POTHOS_TEST_EQUAL(Pothos::ThreadPool(numaArgs).getNodeAffinity(), 0);
+    POTHOS_TEST_EQUAL(Pothos::ThreadPool(Pothos::ThreadPoolArgs(1)).getNodeAffinity(), -1);
+
+    //processors are given by absolute index, even when they are not on the first node
+    Pothos::ThreadPoolArgs lastCpuArgs(1);
+    lastCpuArgs.affinityMode = "CPU";
+    lastCpuArgs.affinity.push_back(std::min<size_t>(Poco::Environment::processorCount(), 32)-1);
+    runThreadPoolTopology(lastCpuArgs, 1);
+
+    //run one chain in a named affinity group pinned to the first processor
+    Pothos::ThreadPoolArgs cpuArgs(1);
+    cpuArgs.affinityMode = "CPU";
+    cpuArgs.affinity.push_back(0);
+
+    auto source0 = std::make_shared<ThreadPoolTestSource>(10000);
+    auto sink0 = std::make_shared<ThreadPoolTestSink>();
+    auto source1 = std::make_shared<ThreadPoolTestSource>(10000);
+    auto sink1 = std::make_shared<ThreadPoolTestSink>();
+    {
+        Pothos::Topology topology;
+        topology.setThreadPoolArgs(Pothos::ThreadPoolArgs(2));
+        topology.setThreadPoolArgs("rx", cpuArgs);
+        topology.setAffinityGroup(source0, "rx");
+        topology.setAffinityGroup(sink0, "rx");
+        topology.connect(source0, 0, sink0, 0);
+        topology.connect(source1, 0, sink1, 0);
+        topology.commit();
+        POTHOS_TEST_TRUE(topology.waitInactive(0.1, 10.0));
+    }
+    POTHOS_TEST_EQUAL(sink0->count, 10000);
+    POTHOS_TEST_EQUAL(sink1->count, 10000);
+    POTHOS_TEST_TRUE(source0->getThreadPool() == sink0->getThreadPool());
+    POTHOS_TEST_TRUE(source1->getThreadPool() == sink1->getThreadPool());
+    POTHOS_TEST_TRUE(not (source0->getThreadPool() == source1->getThreadPool()));
+    POTHOS_TEST_EQUAL(source0->getThreadPool().getArgs().affinityMode, "CPU");
+    POTHOS_TEST_EQUAL(source1->getThreadPool().getArgs().affinityMode, "ALL");
+
+    //an unconfigured group is an error on commit
+    {
+        auto source = std::make_shared<ThreadPoolTestSource>(0);
+        auto sink = std::make_shared<ThreadPoolTestSink>();
+        Pothos::Topology topology;
+        topology.setAffinityGroup(source, "tx");
+        topology.connect(source, 0, sink, 0);
+        POTHOS_TEST_THROWS(topology.commit(), Pothos::TopologyConnectError);
+        topology.disconnectAll();
+    }
+}
+
+POTHOS_TEST_BLOCK("/framework/tests", test_output_buffer_manager)
+{
+    const size_t total = 100000;
+    Pothos::BufferManagerArgs args;
+    args.numBuffers = 8;
+    args.bufferSize = 1024;
+
+    //configured on the port directly
+    auto source0 = std::make_shared<ThreadPoolTestSource>(total);
+    auto sink0 = std::make_shared<ThreadPoolTestSink>();
+    source0->output(0)->setBufferManager("circular", args);
+    POTHOS_TEST_THROWS(source0->output(0)->setBufferManager("foo"), Pothos::BufferManagerFactoryError);
+
+    //configured through the topology
+    auto source1 = std::make_shared<ThreadPoolTestSource>(total);
+    auto sink1 = std::make_shared<ThreadPoolTestSink>();
+
+    {
+        Pothos::Topology topology;
+        topology.setBufferManager(source1, 0, "circular", args);
+        topology.connect(source0, 0, sink0, 0);
+        topology.connect(source1, 0, sink1, 0);
+        topology.commit();
+        POTHOS_TEST_TRUE(topology.waitInactive(0.1, 10.0));
+        POTHOS_TEST_THROWS(source0->output(0)->setBufferManager("generic"), Pothos::PortAccessError);
+    }
+
+    POTHOS_TEST_EQUAL(sink0->count, total);
+    POTHOS_TEST_EQUAL(sink0->errors, 0);
+    POTHOS_TEST_EQUAL(sink1->count, total);
+    POTHOS_TEST_EQUAL(sink1->errors, 0);
+}
+
+/***********************************************************************
+ * Fused chains of blocks:
+ * The source labels and messages every chunk that it produces,
+ * the relays copy the stream, and the sink checks the contents.
+ **********************************************************************/
+struct FusionTestSource : ThreadPoolTestSource
+{
+    FusionTestSource(const size_t total):
+        ThreadPoolTestSource(total)
+    {
+        return;
+    }
+
+    void work(void)
+    {
+        auto out = this->output(0);
+        const unsigned long long index = count;
+        ThreadPoolTestSource::work();
+        if (count == index) return;
+        out->postLabel(Pothos::Label(index, index));
+        out->postMessage(Pothos::Object(index));
+    }
+};
+
+struct FusionTestRelay : Pothos::Block
+{
+    FusionTestRelay(void):
+        count(0)
+    {
+        this->setupInput(0, "int32");
+        this->setupOutput(0, "int32");
+    }
+
+    void work(void)
+    {
+        auto in = this->input(0);
+        auto out = this->output(0);
+        while (in->hasMessage()) out->postMessage(in->popMessage());
+        const size_t n = std::min(in->elements(), out->elements());
+        if (n == 0) return;
+        std::memcpy(out->buffer().as<void *>(), in->buffer().as<const void *>(), n*sizeof(int));
+        in->consume(n);
+        out->produce(n);
+        count += n;
+    }
+
+    size_t count;
+};
+
+struct FusionTestSink : ThreadPoolTestSink
+{
+    FusionTestSink(void):
+        numLabels(0),
+        numMessages(0),
+        lastMessage(0),
+        orderedMessages(true)
+    {
+        return;
+    }
+
+    void work(void)
+    {
+        auto in = this->input(0);
+        while (in->hasMessage())
+        {
+            const auto index = in->popMessage().convert<unsigned long long>();
+            if (numMessages++ != 0 and orderedMessages and index <= lastMessage) errors++;
+            lastMessage = index;
+        }
+        ThreadPoolTestSink::work();
+    }
+
+    void propagateLabels(const Pothos::InputPort *, const Pothos::LabelIteratorRange &labels)
+    {
+        for (const auto &label : labels)
+        {
+            if (label.data.convert<unsigned long long>() != label.index) errors++;
+            numLabels++;
+        }
+    }
+
+    size_t numLabels;
+    size_t numMessages;
+    unsigned long long lastMessage;
+    bool orderedMessages;
+};
+
+POTHOS_TEST_BLOCK("/framework/tests", test_topology_fusion)
+{
+    const size_t total = 100000;
+    const size_t numRelays = 4;
+
+    auto source = std::make_shared<FusionTestSource>(total);
+    auto sink = std::make_shared<FusionTestSink>();
+    std::vector<std::shared_ptr<FusionTestRelay>> relays;
+    for (size_t i = 0; i < numRelays; i++) relays.emplace_back(new FusionTestRelay());
+
+    //the entire chain is fused into a single threaded pool
+    {
+        Pothos::Topology topology;
+        topology.setFusionEnabled(true);
+        topology.connect(source, 0, relays.front(), 0);
+        for (size_t i = 1; i < numRelays; i++) topology.connect(relays[i-1], 0, relays[i], 0);
+        topology.connect(relays.back(), 0, sink, 0);
+        topology.commit();
+        POTHOS_TEST_TRUE(topology.waitInactive(0.1, 10.0));
+
+        const auto &pool = source->getThreadPool();
+        POTHOS_TEST_TRUE(not (pool == Pothos::ThreadPool::getDefault()));
+        POTHOS_TEST_EQUAL(pool.getArgs().numThreads, 1);
+        for (const auto &relay : relays) POTHOS_TEST_TRUE(relay->getThreadPool() == pool);
+        POTHOS_TEST_TRUE(sink->getThreadPool() == pool);
+    }
+
+    POTHOS_TEST_EQUAL(sink->count, total);
+    POTHOS_TEST_EQUAL(sink->errors, 0);
+    POTHOS_TEST_TRUE(sink->numLabels > 0);
+    POTHOS_TEST_TRUE(sink->numMessages > 0);
+
+    //a block excluded from fusion splits the chain
+    source = std::make_shared<FusionTestSource>(total);
+    sink = std::make_shared<FusionTestSink>();
+    for (auto &relay : relays) relay.reset(new FusionTestRelay());
+    {
+        Pothos::Topology topology;
+        topology.setFusionEnabled(true);
+        topology.setFusionEnabled(relays[1], false);
+        topology.connect(source, 0, relays.front(), 0);
+        for (size_t i = 1; i < numRelays; i++) topology.connect(relays[i-1], 0, relays[i], 0);
+        topology.connect(relays.back(), 0, sink, 0);
+        topology.commit();
+        POTHOS_TEST_TRUE(topology.waitInactive(0.1, 10.0));
+
+        POTHOS_TEST_TRUE(relays[0]->getThreadPool() == source->getThreadPool());
+        POTHOS_TEST_TRUE(relays[1]->getThreadPool() == Pothos::ThreadPool::getDefault());
+        POTHOS_TEST_TRUE(relays[3]->getThreadPool() == relays[2]->getThreadPool());
+        POTHOS_TEST_TRUE(sink->getThreadPool() == relays[2]->getThreadPool());
+        POTHOS_TEST_TRUE(not (sink->getThreadPool() == source->getThreadPool()));
+    }
+
+    POTHOS_TEST_EQUAL(sink->count, total);
+    POTHOS_TEST_EQUAL(sink->errors, 0);
+    POTHOS_TEST_TRUE(sink->numLabels > 0);
+    POTHOS_TEST_TRUE(sink->numMessages > 0);
+
+    //a block with a user-set thread pool keeps it and splits the chain
+    source = std::make_shared<FusionTestSource>(total);
+    sink = std::make_shared<FusionTestSink>();
+    for (auto &relay : relays) relay.reset(new FusionTestRelay());
+    Pothos::ThreadPoolArgs pinnedArgs;
+    pinnedArgs.numThreads = 2;
+    const Pothos::ThreadPool pinnedPool(pinnedArgs);
+    relays[1]->setThreadPool(pinnedPool);
+    {
+        Pothos::Topology topology;
+        topology.setFusionEnabled(true);
+        topology.connect(source, 0, relays.front(), 0);
+        for (size_t i = 1; i < numRelays; i++) topology.connect(relays[i-1], 0, relays[i], 0);
+        topology.connect(relays.back(), 0, sink, 0);
+        topology.commit();
+        POTHOS_TEST_TRUE(topology.waitInactive(0.1, 10.0));
+
+        POTHOS_TEST_TRUE(relays[0]->getThreadPool() == source->getThreadPool());
+        POTHOS_TEST_TRUE(relays[1]->getThreadPool() == pinnedPool);
+        POTHOS_TEST_TRUE(sink->getThreadPool() == relays[2]->getThreadPool());
+        POTHOS_TEST_TRUE(not (sink->getThreadPool() == source->getThreadPool()));
+    }
+
+    POTHOS_TEST_EQUAL(sink->count, total);
+    POTHOS_TEST_EQUAL(sink->errors, 0);
+
+    //a change of affinity group splits the chain
+    source = std::make_shared<FusionTestSource>(total);
+    sink = std::make_shared<FusionTestSink>();
+    for (auto &relay : relays) relay.reset(new FusionTestRelay());
+    {
+        Pothos::Topology topology;
+        topology.setFusionEnabled(true);
+        topology.setThreadPoolArgs("fusionGroup", Pothos::ThreadPoolArgs());
+        topology.setAffinityGroup(relays[2], "fusionGroup");
+        topology.setAffinityGroup(relays[3], "fusionGroup");
+        topology.connect(source, 0, relays.front(), 0);
+        for (size_t i = 1; i < numRelays; i++) topology.connect(relays[i-1], 0, relays[i], 0);
+        topology.connect(relays.back(), 0, sink, 0);
+        topology.commit();
+        POTHOS_TEST_TRUE(topology.waitInactive(0.1, 10.0));
+
+        POTHOS_TEST_TRUE(relays[1]->getThreadPool() == source->getThreadPool());
+        POTHOS_TEST_TRUE(relays[3]->getThreadPool() == relays[2]->getThreadPool());
+        POTHOS_TEST_EQUAL(relays[2]->getThreadPool().getArgs().numThreads, 1);
+        POTHOS_TEST_TRUE(not (relays[2]->getThreadPool() == source->getThreadPool()));
+        POTHOS_TEST_TRUE(sink->getThreadPool() == Pothos::ThreadPool::getDefault());
+    }
+
+    POTHOS_TEST_EQUAL(sink->count, total);
+    POTHOS_TEST_EQUAL(sink->errors, 0);
+
+    //fusion is off by default
+    source = std::make_shared<FusionTestSource>(0);
+    sink = std::make_shared<FusionTestSink>();
+    {
+        Pothos::Topology topology;
+        topology.connect(source, 0, sink, 0);
+        topology.commit();
+        POTHOS_TEST_TRUE(sink->getThreadPool() == Pothos::ThreadPool::getDefault());
+    }
+}
+
+POTHOS_TEST_BLOCK("/framework/tests", test_topology_replicas)
+{
+    const size_t total = 100000;
+    const size_t numReplicas = 4;
+
+    auto source = std::make_shared<FusionTestSource>(total);
+    auto sink = std::make_shared<FusionTestSink>();
+    sink->orderedMessages = false; //messages are not ordered across replicas
+    std::vector<std::shared_ptr<FusionTestRelay>> relays;
+    for (size_t i = 0; i < numReplicas; i++) relays.emplace_back(new FusionTestRelay());
+
+    //the stream is dealt to the replicas and merged back in order
+    {
+        Pothos::Topology topology;
+        topology.setThreadPoolArgs(Pothos::ThreadPoolArgs(2));
+        for (size_t i = 1; i < numReplicas; i++) topology.addReplica(relays.front(), relays[i]);
+        topology.connect(source, 0, relays.front(), 0);
+        topology.connect(relays.front(), 0, sink, 0);
+        topology.commit();
+        POTHOS_TEST_TRUE(topology.waitInactive(0.1, 10.0));
+    }
+
+    POTHOS_TEST_EQUAL(sink->count, total);
+    POTHOS_TEST_EQUAL(sink->errors, 0);
+    POTHOS_TEST_TRUE(sink->numLabels > 0);
+    POTHOS_TEST_TRUE(sink->numMessages > 0);
+    size_t relayed = 0;
+    for (const auto &relay : relays)
+    {
+        POTHOS_TEST_TRUE(relay->count > 0);
+        relayed += relay->count;
+    }
+    POTHOS_TEST_EQUAL(relayed, total);
+
+    //a replicated block needs one connected input and output port
+    {
+        auto block = std::make_shared<FusionTestRelay>();
+        auto replica = std::make_shared<FusionTestRelay>();
+        Pothos::Topology topology;
+        POTHOS_TEST_THROWS(topology.addReplica(block, block), Pothos::TopologyConnectError);
+        topology.addReplica(block, replica);
+        topology.connect(std::make_shared<FusionTestSource>(0), 0, block, 0);
+        POTHOS_TEST_THROWS(topology.commit(), Pothos::TopologyConnectError);
+        topology.disconnectAll();
+    }
+}
+
+/***********************************************************************
+ * End-of-stream: a finite source ends its output, the end propagates
+ * through the relays, and waitDone() returns once the sink has drained.
+ * The chunk relay only forwards whole chunks until its input ends,
+ * then it flushes the partial chunk that remains below its reserve
+ * when it opted in, or the remainder is dropped without a work() call.
+ **********************************************************************/
+struct EndOfStreamTestSource : ThreadPoolTestSource
+{
+    EndOfStreamTestSource(const size_t total):
+        ThreadPoolTestSource(total)
+    {
+        return;
+    }
+
+    void work(void)
+    {
+        ThreadPoolTestSource::work();
+        if (count == total) this->output(0)->postEndOfStream();
+    }
+};
+
+struct ChunkTestRelay : Pothos::Block
+{
+    ChunkTestRelay(const size_t chunk, const bool flushAtEnd):
+        chunk(chunk),
+        flushAtEnd(flushAtEnd),
+        belowReserve(0)
+    {
+        this->setupInput(0, "int32");
+        this->setupOutput(0, "int32");
+        this->input(0)->setReserve(chunk);
+        this->input(0)->setFlushAtEnd(flushAtEnd);
+    }
+
+    void work(void)
+    {
+        auto in = this->input(0);
+        auto out = this->output(0);
+        if (in->elements() < chunk) belowReserve++;
+        size_t n = std::min(in->elements(), out->elements());
+        if (not (flushAtEnd and in->isEndOfStream())) n -= n % chunk;
+        if (n == 0) return;
+        std::memcpy(out->buffer().as<void *>(), in->buffer().as<const void *>(), n*sizeof(int));
+        in->consume(n);
+        out->produce(n);
+    }
+
+    const size_t chunk;
+    const bool flushAtEnd;
+    size_t belowReserve; //work() calls with fewer elements than the reserve
+};
+
+static void runEndOfStreamChain(const bool fusion, const bool flushAtEnd)
+{
+    const size_t total = 100003; //not a multiple of the chunk
+    const size_t chunk = 1000;
+    auto source = std::make_shared<EndOfStreamTestSource>(total);
+    auto relay = std::make_shared<FusionTestRelay>();
+    auto chunker = std::make_shared<ChunkTestRelay>(chunk, flushAtEnd);
+    auto sink = std::make_shared<ThreadPoolTestSink>();
+
+    Pothos::Topology topology;
+    topology.setFusionEnabled(fusion);
+    topology.connect(source, 0, relay, 0);
+    topology.connect(relay, 0, chunker, 0);
+    topology.connect(chunker, 0, sink, 0);
+    topology.commit();
+    POTHOS_TEST_TRUE(topology.waitDone(10.0));
+    POTHOS_TEST_EQUAL(sink->errors, 0);
+    POTHOS_TEST_TRUE(sink->input(0)->isEndOfStream());
+
+    //only the block that opted in sees the remainder below its reserve
+    const size_t expected = flushAtEnd?total:(total - total%chunk);
+    POTHOS_TEST_EQUAL(sink->count, expected);
+    if (not flushAtEnd) POTHOS_TEST_EQUAL(chunker->belowReserve, 0);
+
+    //a done topology stays done
+    POTHOS_TEST_TRUE(topology.waitDone(0.0));
+}
+
+/***********************************************************************
+ * End-of-stream behind messages: the source posts messages with its
+ * buffers and right before its end, and the sink must see every one
+ * of them before its input ends and the block is done.
+ **********************************************************************/
+struct MessageEndOfStreamSource : ThreadPoolTestSource
+{
+    MessageEndOfStreamSource(const size_t total, const size_t numTailMessages):
+        ThreadPoolTestSource(total),
+        numTailMessages(numTailMessages),
+        numMessages(0)
+    {
+        return;
+    }
+
+    void work(void)
+    {
+        if (count == total) return;
+        ThreadPoolTestSource::work();
+        this->output(0)->postMessage(Pothos::Object(numMessages++));
+        if (count != total) return;
+        for (size_t i = 0; i < numTailMessages; i++)
+        {
+            this->output(0)->postMessage(Pothos::Object(numMessages++));
+        }
+        this->output(0)->postEndOfStream();
+    }
+
+    const size_t numTailMessages;
+    size_t numMessages;
+};
+
+struct MessageCountSink : ThreadPoolTestSink
+{
+    MessageCountSink(void):
+        numMessages(0)
+    {
+        return;
+    }
+
+    void work(void)
+    {
+        ThreadPoolTestSink::work();
+        auto in = this->input(0);
+        while (in->hasMessage())
+        {
+            in->popMessage();
+            numMessages++;
+        }
+    }
+
+    size_t numMessages;
+};
+
+POTHOS_TEST_BLOCK("/framework/tests", test_end_of_stream)
+{
+    runEndOfStreamChain(false, true);
+    runEndOfStreamChain(true, true);
+    runEndOfStreamChain(false, false);
+    runEndOfStreamChain(true, false);
+
+    //messages posted before the end are delivered before it
+    for (size_t i = 0; i < 10; i++)
+    {
+        auto source = std::make_shared<MessageEndOfStreamSource>(10000, 100);
+        auto sink = std::make_shared<MessageCountSink>();
+        {
+            Pothos::Topology topology;
+            topology.connect(source, 0, sink, 0);
+            topology.commit();
+            POTHOS_TEST_TRUE(topology.waitDone(10.0));
+        }
+        POTHOS_TEST_EQUAL(sink->count, source->total);
+        POTHOS_TEST_EQUAL(sink->numMessages, source->numMessages);
+    }
+
+    //a source that never ends its output keeps the topology running
+    const size_t total = 100000;
+    auto source = std::make_shared<ThreadPoolTestSource>(total);
+    auto sink = std::make_shared<ThreadPoolTestSink>();
+
+    Pothos::Topology topology;
+    topology.connect(source, 0, sink, 0);
+    topology.commit();
+    POTHOS_TEST_TRUE(topology.waitInactive(0.1, 10.0));
+    POTHOS_TEST_TRUE(not topology.waitDone(0.2));
+    POTHOS_TEST_EQUAL(sink->count, total);
+    POTHOS_TEST_TRUE(not sink->input(0)->isEndOfStream());
+}
@@ -3,8 +3,23 @@
 
 #include <Pothos/Testing.hpp>
 #include <Pothos/Framework.hpp>
+#include <Pothos/Proxy.hpp>
+#include "Framework/WorkerStats.hpp"
+#include "Framework/WorkerTrace.hpp"
 #include <iostream>
+#include <algorithm> //min
+#include <iterator> //distance
+#include <cmath> //abs
+#include <set>
+#include <sstream>
 #include <Poco/Thread.h>
+#include <Poco/JSON/Parser.h>
+#include <Poco/Net/HTTPClientSession.h>
+#include <Poco/Net/HTTPRequest.h>
+#include <Poco/Net/HTTPResponse.h>
+#include <Poco/StreamCopier.h>
+#include <atomic>
+#include <thread>
 
 struct MyWorker0 : Pothos::Block
 {
@@ -92,3 +107,594 @@ POTHOS_TEST_BLOCK("/framework/tests", test_workers)
     delete w0;
     //delete w1;
 }
+
+/***********************************************************************
+ * In-place processing through a chain of incrementers
+ **********************************************************************/
+struct InPlaceSource : Pothos::Block
+{
+    InPlaceSource(const size_t numBuffers):
+        numBuffers(numBuffers),
+        count(0)
+    {
+        this->setupOutput(0, "int32");
+    }
+
+    void work(void)
+    {
+        if (numBuffers == 0) return;
+        numBuffers--;
+        Pothos::BufferChunk buffer(1024*sizeof(int));
+        auto p = buffer.as<int *>();
+        for (size_t i = 0; i < 1024; i++) p[i] = int(count++);
+        this->output(0)->postBuffer(buffer);
+    }
+
+    size_t numBuffers;
+    size_t count;
+};
+
+struct InPlaceIncrement : Pothos::Block
+{
+    InPlaceIncrement(void):
+        inPlaceCalls(0)
+    {
+        this->setupInput(0, "int32");
+        this->setupOutput(0, "int32");
+        this->output(0)->setReadBeforeWrite(this->input(0));
+    }
+
+    void work(void)
+    {
+        const size_t n = this->workInfo().minElements;
+        if (n == 0) return;
+        auto in = this->input(0)->buffer().as<const int *>();
+        auto out = this->output(0)->buffer().as<int *>();
+        if ((const int *)out == in) inPlaceCalls++;
+        for (size_t i = 0; i < n; i++) out[i] = in[i] + 1;
+        this->input(0)->consume(n);
+        this->output(0)->produce(n);
+    }
+
+    size_t inPlaceCalls;
+};
+
+struct InPlaceSink : Pothos::Block
+{
+    InPlaceSink(const int offset):
+        offset(offset),
+        count(0),
+        errors(0)
+    {
+        this->setupInput(0, "int32");
+    }
+
+    void work(void)
+    {
+        auto in = this->input(0);
+        auto p = in->buffer().as<const int *>();
+        for (size_t i = 0; i < in->elements(); i++)
+        {
+            if (p[i] != int(count++) + offset) errors++;
+        }
+        in->consume(in->elements());
+    }
+
+    const int offset;
+    size_t count;
+    size_t errors;
+};
+
+POTHOS_TEST_BLOCK("/framework/tests", test_read_before_write)
+{
+    const size_t numBuffers = 100;
+    const size_t numStages = 3;
+
+    //a linear chain holds the only reference to each buffer
+    {
+        auto source = std::make_shared<InPlaceSource>(numBuffers);
+        auto sink = std::make_shared<InPlaceSink>(numStages);
+        std::vector<std::shared_ptr<InPlaceIncrement>> stages;
+        for (size_t i = 0; i < numStages; i++) stages.emplace_back(new InPlaceIncrement());
+        {
+            Pothos::Topology topology;
+            topology.connect(source, 0, stages.front(), 0);
+            for (size_t i = 1; i < numStages; i++) topology.connect(stages[i-1], 0, stages[i], 0);
+            topology.connect(stages.back(), 0, sink, 0);
+            topology.commit();
+            POTHOS_TEST_TRUE(topology.waitInactive(0.1, 10.0));
+        }
+        POTHOS_TEST_EQUAL(sink->count, numBuffers*1024);
+        POTHOS_TEST_EQUAL(sink->errors, 0);
+        for (const auto &stage : stages) POTHOS_TEST_TRUE(stage->inPlaceCalls > 0);
+    }
+
+    //a shared input must not be written over
+    {
+        auto source = std::make_shared<InPlaceSource>(numBuffers);
+        auto stage = std::make_shared<InPlaceIncrement>();
+        auto sink0 = std::make_shared<InPlaceSink>(1);
+        auto sink1 = std::make_shared<InPlaceSink>(0);
+        {
+            Pothos::Topology topology;
+            topology.connect(source, 0, stage, 0);
+            topology.connect(stage, 0, sink0, 0);
+            topology.connect(source, 0, sink1, 0);
+            topology.commit();
+            POTHOS_TEST_TRUE(topology.waitInactive(0.1, 10.0));
+        }
+        POTHOS_TEST_EQUAL(sink0->count, numBuffers*1024);
+        POTHOS_TEST_EQUAL(sink0->errors, 0);
+        POTHOS_TEST_EQUAL(sink1->count, numBuffers*1024);
+        POTHOS_TEST_EQUAL(sink1->errors, 0);
+    }
+}
+
+/***********************************************************************
+ * Labels from several upstream ports are merged in index order
+ **********************************************************************/
+struct LabelOrderSource : Pothos::Block
+{
+    LabelOrderSource(const size_t total, const size_t spacing):
+        total(total),
+        spacing(spacing),
+        count(0)
+    {
+        this->setupOutput(0, "int32");
+    }
+
+    void work(void)
+    {
+        auto out = this->output(0);
+        const size_t n = std::min(out->elements(), total-count);
+        for (size_t i = 0; i < n; i++)
+        {
+            if ((count+i) % spacing == 0) out->postLabel(Pothos::Label(count+i, count+i));
+        }
+        count += n;
+        out->produce(n);
+    }
+
+    const size_t total;
+    const size_t spacing;
+    size_t count;
+};
+
+struct LabelOrderSink : Pothos::Block
+{
+    LabelOrderSink(void):
+        numLabels(0),
+        errors(0)
+    {
+        this->setupInput(0, "int32");
+    }
+
+    void work(void)
+    {
+        auto in = this->input(0);
+        unsigned long long last = 0;
+        for (const auto &label : in->labels())
+        {
+            if (label.index < last) errors++;
+            last = label.index;
+        }
+        in->consume(in->elements());
+    }
+
+    void propagateLabels(const Pothos::InputPort *, const Pothos::LabelIteratorRange &labels)
+    {
+        numLabels += std::distance(labels.begin(), labels.end());
+    }
+
+    size_t numLabels;
+    size_t errors;
+};
+
+POTHOS_TEST_BLOCK("/framework/tests", test_label_order)
+{
+    const size_t total = 100000;
+    auto source0 = std::make_shared<LabelOrderSource>(total, 7);
+    auto source1 = std::make_shared<LabelOrderSource>(total, 11);
+    auto sink = std::make_shared<LabelOrderSink>();
+
+    {
+        Pothos::Topology topology;
+        topology.connect(source0, 0, sink, 0);
+        topology.connect(source1, 0, sink, 0);
+        topology.commit();
+        POTHOS_TEST_TRUE(topology.waitInactive(0.1, 10.0));
+    }
+
+    POTHOS_TEST_EQUAL(sink->errors, 0);
+    POTHOS_TEST_EQUAL(sink->numLabels, (total+6)/7 + (total+10)/11);
+}
+
+/***********************************************************************
+ * Bounded message queues: a gated consumer holds its messages
+ * until opened, while the producer posts as fast as it can
+ **********************************************************************/
+struct MessageFloodSource : Pothos::Block
+{
+    MessageFloodSource(const size_t total):
+        total(total),
+        count(0)
+    {
+        this->setupOutput(0, "int32");
+    }
+
+    void work(void)
+    {
+        for (size_t i = 0; i < 10 and count < total; i++)
+        {
+            this->output(0)->postMessage(Pothos::Object(count++));
+        }
+    }
+
+    const size_t total;
+    std::atomic<size_t> count;
+};
+
+struct GatedMessageSink : Pothos::Block
+{
+    GatedMessageSink(void):
+        open(false),
+        count(0)
+    {
+        this->setupInput(0, "int32");
+        this->registerCall(POTHOS_FCN_TUPLE(GatedMessageSink, openGate));
+    }
+
+    void openGate(void)
+    {
+        open = true;
+    }
+
+    void work(void)
+    {
+        if (not open) return;
+        auto in = this->input(0);
+        while (in->hasMessage())
+        {
+            in->popMessage();
+            count++;
+        }
+    }
+
+    bool open;
+    std::atomic<size_t> count;
+};
+
+struct DualGatedMessageSink : GatedMessageSink
+{
+    DualGatedMessageSink(void)
+    {
+        this->setupInput(1, "int32");
+    }
+};
+
+POTHOS_TEST_BLOCK("/framework/tests", test_message_depth)
+{
+    const size_t total = 100000;
+    const size_t depth = 100;
+
+    //backpressure stalls the producer while the consumer is closed
+    {
+        auto source = std::make_shared<MessageFloodSource>(total);
+        auto sink = std::make_shared<GatedMessageSink>();
+        sink->input(0)->setMessageDepth(depth);
+        POTHOS_TEST_THROWS(sink->input(0)->setMessageDepth(depth, "FOO"), Pothos::PortAccessError);
+
+        Pothos::Topology topology;
+        topology.connect(source, 0, sink, 0);
+        topology.commit();
+        Poco::Thread::sleep(500);
+        POTHOS_TEST_TRUE(source->count < total/10);
+        const size_t stalledCount = source->count;
+        Poco::Thread::sleep(200);
+        POTHOS_TEST_EQUAL(source->count, stalledCount);
+
+        //the producer resumes as the consumer drains the queue
+        sink->opaqueCall("openGate", nullptr, 0);
+        for (size_t i = 0; i < 100 and sink->count < total; i++) Poco::Thread::sleep(100);
+        POTHOS_TEST_EQUAL(source->count, total);
+        POTHOS_TEST_EQUAL(sink->count, total);
+        POTHOS_TEST_EQUAL(sink->input(0)->droppedMessages(), 0);
+    }
+
+    //the drop policy discards the messages beyond the depth
+    {
+        auto source = std::make_shared<MessageFloodSource>(total);
+        auto sink = std::make_shared<GatedMessageSink>();
+        sink->input(0)->setMessageDepth(depth, "DROP");
+
+        Pothos::Topology topology;
+        topology.connect(source, 0, sink, 0);
+        topology.commit();
+        for (size_t i = 0; i < 100 and sink->input(0)->droppedMessages() < total-depth; i++) Poco::Thread::sleep(100);
+        POTHOS_TEST_EQUAL(source->count, total);
+        POTHOS_TEST_EQUAL(sink->input(0)->droppedMessages(), total-depth);
+
+        sink->opaqueCall("openGate", nullptr, 0);
+        for (size_t i = 0; i < 100 and sink->count < depth; i++) Poco::Thread::sleep(100);
+        POTHOS_TEST_EQUAL(sink->count, depth);
+    }
+
+    //disconnecting the full port releases the producer while both blocks stay active
+    {
+        auto source = std::make_shared<MessageFloodSource>(total);
+        auto sink = std::make_shared<DualGatedMessageSink>();
+        sink->input(0)->setMessageDepth(depth);
+
+        Pothos::Topology topology;
+        topology.connect(source, 0, sink, 0);
+        topology.connect(source, 0, sink, 1);
+        topology.commit();
+        Poco::Thread::sleep(200);
+        POTHOS_TEST_TRUE(source->count < total);
+
+        topology.disconnect(source, 0, sink, 0);
+        topology.commit();
+        for (size_t i = 0; i < 100 and source->count < total; i++) Poco::Thread::sleep(100);
+        POTHOS_TEST_EQUAL(source->count, total);
+    }
+}
+
+/***********************************************************************
+ * Per-port stats: a source posts a stream with labels and messages,
+ * and the stats of both ends must agree on what crossed the edge
+ **********************************************************************/
+struct StatsSource : Pothos::Block
+{
+    StatsSource(const size_t total):
+        total(total),
+        count(0)
+    {
+        this->setupOutput(0, "int32");
+    }
+
+    void work(void)
+    {
+        auto out = this->output(0);
+        const size_t n = std::min(out->elements(), total-count);
+        if (n == 0) return;
+        for (size_t i = 0; i < n; i++)
+        {
+            if ((count+i) % 100 == 0) out->postLabel(Pothos::Label(Pothos::Object(), count+i));
+        }
+        out->postMessage(Pothos::Object(count));
+        count += n;
+        out->produce(n);
+    }
+
+    const size_t total;
+    size_t count;
+};
+
+struct StatsSink : Pothos::Block
+{
+    StatsSink(void):
+        count(0)
+    {
+        this->setupInput(0, "int32");
+    }
+
+    void work(void)
+    {
+        auto in = this->input(0);
+        while (in->hasMessage()) in->popMessage();
+        count += in->elements();
+        in->consume(in->elements());
+    }
+
+    std::atomic<size_t> count;
+};
+
+static WorkerStats getWorkerStats(const std::shared_ptr<Pothos::Block> &block)
+{
+    auto cls = Pothos::ProxyEnvironment::make("managed")->findProxy("Pothos/WorkerActorInterface");
+    return cls.callProxy("new", block->_actor).call<WorkerStats>("getWorkerStats");
+}
+
+POTHOS_TEST_BLOCK("/framework/tests", test_worker_stats)
+{
+    const size_t total = 100000;
+    auto source = std::make_shared<StatsSource>(total);
+    auto sink = std::make_shared<StatsSink>();
+
+    Pothos::Topology topology;
+    topology.connect(source, 0, sink, 0);
+    topology.commit();
+    POTHOS_TEST_TRUE(topology.waitInactive(0.1, 10.0));
+
+    const auto sourceStats = getWorkerStats(source);
+    const auto sinkStats = getWorkerStats(sink);
+    POTHOS_TEST_EQUAL(sourceStats.outputStats.size(), 1);
+    POTHOS_TEST_EQUAL(sinkStats.inputStats.size(), 1);
+    const auto &out = sourceStats.outputStats.at("0");
+    const auto &in = sinkStats.inputStats.at("0");
+
+    //both ends of the edge see the same traffic
+    POTHOS_TEST_EQUAL(out.totalElements, total);
+    POTHOS_TEST_EQUAL(in.totalElements, total);
+    POTHOS_TEST_EQUAL(out.totalLabels, total/100);
+    POTHOS_TEST_EQUAL(in.totalLabels, total/100);
+    POTHOS_TEST_TRUE(out.totalMessages > 0);
+    POTHOS_TEST_EQUAL(in.totalMessages, out.totalMessages);
+    POTHOS_TEST_EQUAL(in.queuedElements, 0);
+    POTHOS_TEST_EQUAL(in.queuedMessages, 0);
+    POTHOS_TEST_EQUAL(in.queuedLabels, 0);
+    POTHOS_TEST_TRUE(in.ticksLastBuffer != 0);
+    POTHOS_TEST_TRUE(in.ticksLastMessage != 0);
+    POTHOS_TEST_TRUE(in.ticksLastLabel != 0);
+
+    //the idle sink is starved since the source finished
+    POTHOS_TEST_TRUE(in.totalTicksBlocked >= 0.1*sinkStats.tickRate);
+
+    //every work() call lands in the histogram
+    unsigned long long numBinned = 0;
+    for (const auto count : sinkStats.workHistogram) numBinned += count;
+    POTHOS_TEST_EQUAL(numBinned, sinkStats.numWorkCalls);
+}
+
+POTHOS_TEST_BLOCK("/framework/tests", test_topology_stats)
+{
+    const size_t total = 100000;
+    auto source = std::make_shared<StatsSource>(total);
+    auto sink = std::make_shared<StatsSink>();
+
+    Pothos::Topology topology;
+    topology.connect(source, 0, sink, 0);
+    topology.commit();
+    POTHOS_TEST_TRUE(topology.waitInactive(0.1, 10.0));
+
+    const auto stats = topology.queryStats();
+    POTHOS_TEST_EQUAL(stats.blocks.size(), 2);
+    POTHOS_TEST_EQUAL(stats.edges.size(), 1);
+
+    double cpuShare = 0.0;
+    for (const auto &block : stats.blocks)
+    {
+        POTHOS_TEST_TRUE(block.uid == source->uid() or block.uid == sink->uid());
+        POTHOS_TEST_TRUE(block.numWorkCalls > 0);
+        POTHOS_TEST_TRUE(block.elapsedTime >= 0.1);
+        cpuShare += block.cpuShare;
+    }
+    POTHOS_TEST_TRUE(std::abs(cpuShare-1.0) < 1e-6);
+
+    const auto &edge = stats.edges.front();
+    POTHOS_TEST_EQUAL(edge.srcUid, source->uid());
+    POTHOS_TEST_EQUAL(edge.dstUid, sink->uid());
+    POTHOS_TEST_EQUAL(edge.srcPort, "0");
+    POTHOS_TEST_EQUAL(edge.dstPort, "0");
+    POTHOS_TEST_EQUAL(edge.totalElements, total);
+    POTHOS_TEST_EQUAL(edge.totalLabels, total/100);
+    POTHOS_TEST_TRUE(edge.elementRate > 0.0);
+    POTHOS_TEST_TRUE(edge.dstBlockedTime >= 0.1);
+
+    //the dumps name every block and flow
+    const auto json = stats.toJSON();
+    Poco::JSON::Parser parser;
+    const auto topObj = parser.parse(json).extract<Poco::JSON::Object::Ptr>();
+    POTHOS_TEST_EQUAL(topObj->getArray("blocks")->size(), 2);
+    POTHOS_TEST_EQUAL(topObj->getArray("edges")->size(), 1);
+    const auto dot = stats.toDotMarkup();
+    POTHOS_TEST_TRUE(dot.find(source->uid()+"\" -> \""+sink->uid()) != std::string::npos);
+}
+
+POTHOS_TEST_BLOCK("/framework/tests", test_worker_trace)
+{
+    const size_t total = 10000;
+    auto source = std::make_shared<StatsSource>(total);
+    auto sink = std::make_shared<StatsSink>();
+
+    //stop tracing once the data arrives, before the idle work calls fill the rings
+    Pothos::Trace::clear();
+    Pothos::Trace::setEnabled(true);
+    {
+        Pothos::Topology topology;
+        topology.connect(source, 0, sink, 0);
+        topology.commit();
+        for (size_t i = 0; i < 1000 and sink->count < total; i++) Poco::Thread::sleep(10);
+        Pothos::Trace::setEnabled(false);
+        POTHOS_TEST_EQUAL(sink->count, total);
+    }
+    POTHOS_TEST_TRUE(not Pothos::Trace::isEnabled());
+
+    //collect the event names that were recorded for each block
+    std::set<std::string> sourceEvents, sinkEvents;
+    Poco::JSON::Parser parser;
+    const auto topObj = parser.parse(Pothos::Trace::toJSON()).extract<Poco::JSON::Object::Ptr>();
+    const auto events = topObj->getArray("traceEvents");
+    for (size_t i = 0; i < events->size(); i++)
+    {
+        const auto event = events->getObject(i);
+        const auto block = event->getObject("args")->getValue<std::string>("block");
+        const auto name = event->getValue<std::string>("name");
+        if (event->getValue<std::string>("ph") == "X") POTHOS_TEST_TRUE(event->getValue<double>("dur") >= 0.0);
+        if (block == source->uid()) sourceEvents.insert(name);
+        if (block == sink->uid()) sinkEvents.insert(name);
+    }
+    POTHOS_TEST_TRUE(sourceEvents.count("work") != 0);
+    POTHOS_TEST_TRUE(sourceEvents.count("sendBuffer") != 0);
+    POTHOS_TEST_TRUE(sourceEvents.count("sendMessage") != 0);
+    POTHOS_TEST_TRUE(sinkEvents.count("preWork") != 0);
+    POTHOS_TEST_TRUE(sinkEvents.count("work") != 0);
+    POTHOS_TEST_TRUE(sinkEvents.count("postWork") != 0);
+    POTHOS_TEST_TRUE(sinkEvents.count("recvBuffer") != 0);
+
+    //cleared events are not dumped
+    Pothos::Trace::clear();
+    parser.reset();
+    const auto cleared = parser.parse(Pothos::Trace::toJSON()).extract<Poco::JSON::Object::Ptr>();
+    POTHOS_TEST_EQUAL(cleared->getArray("traceEvents")->size(), 0);
+    POTHOS_TEST_THROWS(Pothos::Trace::writeFile("/no/such/dir/trace.json"), Pothos::FileException);
+
+    //the ring of an exited thread is reused by the next thread
+    Pothos::Trace::setEnabled(true);
+    for (size_t i = 0; i < 10; i++)
+    {
+        std::thread([](void){recordTraceInstant("ringReuse", "test");}).join();
+    }
+    Pothos::Trace::setEnabled(false);
+    parser.reset();
+    const auto reused = parser.parse(Pothos::Trace::toJSON()).extract<Poco::JSON::Object::Ptr>()->getArray("traceEvents");
+    std::set<int> tids;
+    for (size_t i = 0; i < reused->size(); i++)
+    {
+        const auto event = reused->getObject(i);
+        if (event->getValue<std::string>("name") == "ringReuse") tids.insert(event->getValue<int>("tid"));
+    }
+    POTHOS_TEST_EQUAL(tids.size(), 1);
+}
+
+static std::string httpGet(const unsigned short port, const std::string &path, Poco::Net::HTTPResponse &response)
+{
+    Poco::Net::HTTPClientSession session("localhost", port);
+    Poco::Net::HTTPRequest request(Poco::Net::HTTPRequest::HTTP_GET, path);
+    session.sendRequest(request);
+    std::stringstream ss;
+    Poco::StreamCopier::copyStream(session.receiveResponse(response), ss);
+    return ss.str();
+}
+
+POTHOS_TEST_BLOCK("/framework/tests", test_metrics_server)
+{
+    const size_t total = 100000;
+    auto source = std::make_shared<StatsSource>(total);
+    auto sink = std::make_shared<StatsSink>();
+
+    Pothos::Topology topology;
+    topology.connect(source, 0, sink, 0);
+    topology.commit();
+    POTHOS_TEST_TRUE(topology.waitInactive(0.1, 10.0));
+
+    //the workers do not publish without a server
+    const auto sinkLabels = "{block=\""+sink->uid()+"\",port=\"0\",direction=\"input\"} ";
+    const auto sinkElements = "pothos_port_elements_total"+sinkLabels+std::to_string(total)+"\n";
+    POTHOS_TEST_TRUE(Pothos::MetricsServer::getMetricsText().find(sinkElements) == std::string::npos);
+
+    //the idle workers publish once when the server starts
+    Pothos::MetricsServer server;
+    POTHOS_TEST_TRUE(server.getPort() != 0);
+    Poco::Net::HTTPResponse response;
+    std::string text;
+    for (size_t i = 0; i < 100 and text.find(sinkElements) == std::string::npos; i++)
+    {
+        Poco::Thread::sleep(10);
+        text = httpGet(server.getPort(), "/metrics", response);
+        POTHOS_TEST_EQUAL(response.getStatus(), Poco::Net::HTTPResponse::HTTP_OK);
+    }
+
+    //the counters match the traffic through the edge
+    const auto sourceLabels = "{block=\""+source->uid()+"\",port=\"0\",direction=\"output\"} ";
+    POTHOS_TEST_TRUE(text.find(sinkElements) != std::string::npos);
+    POTHOS_TEST_TRUE(text.find("pothos_port_elements_total"+sourceLabels+std::to_string(total)+"\n") != std::string::npos);
+    POTHOS_TEST_TRUE(text.find("pothos_port_labels_total"+sinkLabels+std::to_string(total/100)+"\n") != std::string::npos);
+    POTHOS_TEST_TRUE(text.find("pothos_port_queued_elements"+sinkLabels+"0\n") != std::string::npos);
+    POTHOS_TEST_TRUE(text.find("pothos_block_active{block=\""+sink->uid()+"\"} 1\n") != std::string::npos);
+    POTHOS_TEST_TRUE(text.find("# TYPE pothos_block_work_calls_total counter\n") != std::string::npos);
+
+    httpGet(server.getPort(), "/", response);
+    POTHOS_TEST_EQUAL(response.getStatus(), Poco::Net::HTTPResponse::HTTP_NOT_FOUND);
+    POTHOS_TEST_THROWS(Pothos::MetricsServer(server.getPort()), Pothos::MetricsServerError);
+}
@@ -2,6 +2,7 @@
 // SPDX-License-Identifier: BSL-1.0
 
 #include "Framework/InputPortImpl.hpp"
+#include <Pothos/Framework/Exception.hpp>
 
 Pothos::InputPort::InputPort(InputPortImpl *impl):
     _impl(impl),
@@ -10,7 +11,8 @@ Pothos::InputPort::InputPort(InputPortImpl *impl):
     _totalElements(0),
     _totalMessages(0),
     _pendingElements(0),
-    _reserveElements(0)
+    _reserveElements(0),
+    _flushAtEnd(false)
 {
     return;
 }
@@ -39,15 +41,28 @@ Pothos::Object Pothos::InputPort::popMessage(void)
 void Pothos::InputPort::removeLabel(const Label &label)
 {
     assert(_impl);
-    for (auto it = _impl->inlineMessages.begin(); it != _impl->inlineMessages.end(); it++)
-    {
-        if (*it == label)
-        {
-            _impl->inlineMessages.erase(it);
-            _labelIter = _impl->inlineMessages;
-            return;
-        }
-    }
+    if (_impl->inlineMessages.erase(label)) _labelIter = _impl->inlineMessages.range();
+}
+
+void Pothos::InputPort::setMessageDepth(const size_t depth, const std::string &policy)
+{
+    assert(_impl);
+    if (policy != "BACKPRESSURE" and policy != "DROP") throw PortAccessError(
+        "Pothos::InputPort::setMessageDepth("+policy+")", "unknown message policy");
+    _impl->messageDepth = depth;
+    _impl->dropMessages = (policy == "DROP");
+}
+
+unsigned long long Pothos::InputPort::droppedMessages(void) const
+{
+    assert(_impl);
+    return _impl->droppedMessages;
+}
+
+bool Pothos::InputPort::isEndOfStream(void) const
+{
+    assert(_impl);
+    return not _impl->subscribers.empty() and _impl->numEndOfStream >= _impl->subscribers.size();
 }
 
 #include <Pothos/Managed.hpp>
@@ -67,4 +82,8 @@ static auto managedInputPort = Pothos::ManagedClass()
     .registerMethod(POTHOS_FCN_TUPLE(Pothos::InputPort, consume))
     .registerMethod(POTHOS_FCN_TUPLE(Pothos::InputPort, popMessage))
     .registerMethod(POTHOS_FCN_TUPLE(Pothos::InputPort, setReserve))
+    .registerMethod(POTHOS_FCN_TUPLE(Pothos::InputPort, setFlushAtEnd))
+    .registerMethod(POTHOS_FCN_TUPLE(Pothos::InputPort, setMessageDepth))
+    .registerMethod(POTHOS_FCN_TUPLE(Pothos::InputPort, droppedMessages))
+    .registerMethod(POTHOS_FCN_TUPLE(Pothos::InputPort, isEndOfStream))
     .commit("Pothos/InputPort");
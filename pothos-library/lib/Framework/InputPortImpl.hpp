@@ -3,6 +3,8 @@
 
 #pragma once
 #include "Framework/PortSubscriber.hpp"
+#include "Framework/WorkerStats.hpp"
+#include "Framework/LabelQueue.hpp"
 #include <Pothos/Framework/InputPort.hpp>
 #include <Pothos/Framework/BufferAccumulator.hpp>
 #include <Pothos/Util/RingDeque.hpp>
@@ -11,9 +13,29 @@
 class Pothos::InputPortImpl
 {
 public:
+    InputPortImpl(void):
+        readBeforeWrite(false),
+        bufferInPlace(false),
+        messageDepth(0),
+        dropMessages(false),
+        droppedMessages(0),
+        numEndOfStream(0),
+        actor(nullptr)
+    {
+        return;
+    }
+
     Util::RingDeque<Object> asyncMessages;
-    std::vector<Label> inlineMessages;
+    LabelQueue inlineMessages;
     BufferAccumulator bufferAccumulator;
     std::vector<PortSubscriber> subscribers;
+    bool readBeforeWrite; //an output port may borrow the buffer
+    bool bufferInPlace; //the current buffer may be written in-place
+    size_t messageDepth; //async message limit, zero for no limit
+    bool dropMessages; //drop instead of throttling at the limit
+    unsigned long long droppedMessages;
+    std::vector<Theron::Address> throttledProducers;
+    size_t numEndOfStream; //upstream ports that ended
+    PortStats stats;
     WorkerActor *actor;
 };
@@ -0,0 +1,93 @@
+// Copyright (c) 2014-2014 Josh Blum
+// SPDX-License-Identifier: BSL-1.0
+
+#pragma once
+#include <Pothos/Framework/Label.hpp>
+#include <algorithm> //upper_bound
+#include <vector>
+
+/***********************************************************************
+ * LabelQueue holds the labels of an input port sorted by index.
+ * Labels from one upstream port arrive in order and are appended,
+ * others are inserted after the labels with the same or lower index.
+ * Retired labels are skipped at the front in constant time,
+ * and their storage is reclaimed once it outweighs the live labels.
+ * The live labels are contiguous for the LabelIteratorRange.
+ **********************************************************************/
+class LabelQueue
+{
+public:
+    LabelQueue(void):
+        _front(0)
+    {
+        return;
+    }
+
+    //! Insert a label in sorted order
+    void push(const Pothos::Label &label)
+    {
+        if (this->empty() or not (label < _labels.back())) _labels.push_back(label);
+        else _labels.insert(std::upper_bound(_labels.begin()+_front, _labels.end(), label), label);
+    }
+
+    //! Retire the first num labels
+    void pop(const size_t num)
+    {
+        _front += num;
+        if (_front == _labels.size())
+        {
+            _labels.clear();
+            _front = 0;
+        }
+        else if (_front*2 >= _labels.size() and _front >= 64)
+        {
+            _labels.erase(_labels.begin(), _labels.begin()+_front);
+            _front = 0;
+        }
+    }
+
+    //! Remove the first label equal to this one
+    bool erase(const Pothos::Label &label)
+    {
+        for (auto it = _labels.begin()+_front; it != _labels.end(); ++it)
+        {
+            if (not (*it == label)) continue;
+            _labels.erase(it);
+            return true;
+        }
+        return false;
+    }
+
+    //! Number of live labels
+    size_t size(void) const
+    {
+        return _labels.size()-_front;
+    }
+
+    bool empty(void) const
+    {
+        return _labels.size() == _front;
+    }
+
+    //! Access a live label, 0 is the front
+    const Pothos::Label &operator[](const size_t offset) const
+    {
+        return _labels[_front+offset];
+    }
+
+    //! Range of the first num live labels
+    Pothos::LabelIteratorRange range(const size_t num) const
+    {
+        return Pothos::LabelIteratorRange(_labels.begin()+_front, _labels.begin()+_front+num);
+    }
+
+    //! Range of all live labels
+    Pothos::LabelIteratorRange range(void) const
+    {
+        return this->range(this->size());
+    }
+
+private:
+    std::vector<Pothos::Label> _labels;
+    size_t _front;
+};
@@ -94,6 +94,11 @@ size_t Pothos::ManagedBuffer::getSlabIndex(void) const
     return _impl->slabIndex;
 }
 
+bool Pothos::ManagedBuffer::unique(void) const
+{
+    return _impl != nullptr and _impl->counter.value() == 1;
+}
+
 bool Pothos::operator==(const ManagedBuffer &lhs, const ManagedBuffer &rhs)
 {
     return lhs._impl == rhs._impl;
@@ -0,0 +1,238 @@
+// Copyright (c) 2014-2014 Josh Blum
+// SPDX-License-Identifier: BSL-1.0
+
+#include "Framework/WorkerMetrics.hpp"
+#include <Pothos/Framework/MetricsServer.hpp>
+#include <Pothos/Framework/Exception.hpp>
+#include <Theron/Detail/Threading/Clock.h>
+#include <Poco/Net/HTTPServer.h>
+#include <Poco/Net/HTTPServerParams.h>
+#include <Poco/Net/HTTPRequestHandler.h>
+#include <Poco/Net/HTTPRequestHandlerFactory.h>
+#include <Poco/Net/HTTPServerRequest.h>
+#include <Poco/Net/HTTPServerResponse.h>
+#include <Poco/Net/ServerSocket.h>
+#include <functional>
+#include <sstream>
+
+/***********************************************************************
+ * Prometheus text exposition of the worker metrics
+ **********************************************************************/
+static std::string escapeLabelValue(const std::string &value)
+{
+    std::string out;
+    for (const auto ch : value)
+    {
+        if (ch == '\\') out += "\\\\";
+        else if (ch == '"') out += "\\\"";
+        else if (ch == '\n') out += "\\n";
+        else out += ch;
+    }
+    return out;
+}
+
+typedef std::shared_ptr<WorkerMetrics> WorkerMetricsPtr;
+typedef std::shared_ptr<PortMetrics> PortMetricsPtr;
+
+struct MetricsWriter
+{
+    MetricsWriter(void):
+        secondsPerTick(1.0/Theron::Detail::Clock::GetFrequency()),
+        ticksNow(Theron::Detail::Clock::GetTicks())
+    {
+        ss.precision(15);
+    }
+
+    void header(const char *name, const char *type, const char *help)
+    {
+        ss << "# HELP " << name << " " << help << "\n";
+        ss << "# TYPE " << name << " " << type << "\n";
+    }
+
+    void sample(const char *name, const std::string &labels, const double value)
+    {
+        ss << name << "{" << labels << "} " << value << "\n";
+    }
+
+    //one sample per block, the value is taken from the worker metrics
+    void blockFamily(const char *name, const char *type, const char *help,
+        const std::function<double(const WorkerMetrics &)> &value)
+    {
+        this->header(name, type, help);
+        for (const auto &worker : workers)
+        {
+            this->sample(name, "block=\""+escapeLabelValue(worker->uid)+"\"", value(*worker));
+        }
+    }
+
+    //one sample per port of the given direction, or of both directions
+    void portFamily(const char *name, const char *type, const char *help, const int direction,
+        const std::function<double(const PortMetrics &)> &value)
+    {
+        this->header(name, type, help);
+        for (size_t i = 0; i < workers.size(); i++)
+        {
+            for (const auto &port : ports[i])
+            {
+                if (direction == 1 and not port->isInput) continue;
+                if (direction == 0 and port->isInput) continue;
+                const std::string labels = "block=\""+escapeLabelValue(workers[i]->uid)+"\","
+                    "port=\""+escapeLabelValue(port->name)+"\","
+                    "direction=\""+(port->isInput?"input":"output")+"\"";
+                this->sample(name, labels, value(*port));
+            }
+        }
+    }
+
+    const double secondsPerTick;
+    const unsigned long long ticksNow;
+    std::vector<WorkerMetricsPtr> workers;
+    std::vector<std::vector<PortMetricsPtr>> ports;
+    std::stringstream ss;
+};
+
+std::string Pothos::MetricsServer::getMetricsText(void)
+{
+    MetricsWriter w;
+    w.workers = getAllWorkerMetrics();
+    for (const auto &worker : w.workers)
+    {
+        std::lock_guard<std::mutex> lock(worker->portsMutex);
+        w.ports.push_back(worker->ports);
+    }
+    const auto seconds = w.secondsPerTick;
+    const auto now = w.ticksNow;
+    const int INPUT = 1, OUTPUT = 0, BOTH = -1;
+
+    w.blockFamily("pothos_block_active", "gauge", "Is the block active in a topology.",
+        [](const WorkerMetrics &m){return m.active.load()?1.0:0.0;});
+    w.blockFamily("pothos_block_work_calls_total", "counter", "Number of calls to work().",
+        [](const WorkerMetrics &m){return double(m.numWorkCalls.load());});
+    w.blockFamily("pothos_block_work_seconds_total", "counter", "Time spent in work().",
+        [=](const WorkerMetrics &m){return m.totalTicksWork.load()*seconds;});
+    w.blockFamily("pothos_block_pre_work_seconds_total", "counter", "Time spent in the pre-work tasks.",
+        [=](const WorkerMetrics &m){return m.totalTicksPreWork.load()*seconds;});
+    w.blockFamily("pothos_block_post_work_seconds_total", "counter", "Time spent in the post-work tasks.",
+        [=](const WorkerMetrics &m){return m.totalTicksPostWork.load()*seconds;});
+    w.blockFamily("pothos_block_consumed_bytes_total", "counter", "Stream bytes consumed from all inputs.",
+        [](const WorkerMetrics &m){return double(m.bytesConsumed.load());});
+    w.blockFamily("pothos_block_produced_bytes_total", "counter", "Stream bytes produced to all outputs.",
+        [](const WorkerMetrics &m){return double(m.bytesProduced.load());});
+    w.blockFamily("pothos_block_consumed_messages_total", "counter", "Messages consumed from all inputs.",
+        [](const WorkerMetrics &m){return double(m.msgsConsumed.load());});
+    w.blockFamily("pothos_block_produced_messages_total", "counter", "Messages produced to all outputs.",
+        [](const WorkerMetrics &m){return double(m.msgsProduced.load());});
+    w.blockFamily("pothos_block_buffer_pool_hits_total", "counter", "Input reserve copies that reused a pooled buffer.",
+        [](const WorkerMetrics &m){return double(m.bufferPoolHits.load());});
+    w.blockFamily("pothos_block_buffer_pool_misses_total", "counter", "Input reserve copies that allocated a buffer.",
+        [](const WorkerMetrics &m){return double(m.bufferPoolMisses.load());});
+
+    w.portFamily("pothos_port_elements_total", "counter", "Stream elements that passed through the port.", BOTH,
+        [](const PortMetrics &m){return double(m.totalElements.load());});
+    w.portFamily("pothos_port_messages_total", "counter", "Messages that passed through the port.", BOTH,
+        [](const PortMetrics &m){return double(m.totalMessages.load());});
+    w.portFamily("pothos_port_labels_total", "counter", "Labels that passed through the port.", BOTH,
+        [](const PortMetrics &m){return double(m.totalLabels.load());});
+    w.portFamily("pothos_port_blocked_seconds_total", "counter",
+        "Time an input was starved, or an output waited on a buffer or a throttled consumer.", BOTH,
+        [=](const PortMetrics &m)
+        {
+            auto ticks = m.totalTicksBlocked.load();
+            const auto since = m.ticksBlockedSince.load();
+            if (since != 0 and since < now) ticks += now - since;
+            return ticks*seconds;
+        });
+    w.portFamily("pothos_port_queued_elements", "gauge", "Stream elements waiting at the input.", INPUT,
+        [](const PortMetrics &m){return double(m.queuedElements.load());});
+    w.portFamily("pothos_port_queued_messages", "gauge", "Messages waiting at the input.", INPUT,
+        [](const PortMetrics &m){return double(m.queuedMessages.load());});
+    w.portFamily("pothos_port_queued_labels", "gauge", "Labels waiting at the input.", INPUT,
+        [](const PortMetrics &m){return double(m.queuedLabels.load());});
+    w.portFamily("pothos_port_dropped_messages_total", "counter", "Messages dropped at the full input queue.", INPUT,
+        [](const PortMetrics &m){return double(m.droppedMessages.load());});
+    w.portFamily("pothos_port_buffers_ready", "gauge", "Output buffers ready for the block to fill.", OUTPUT,
+        [](const PortMetrics &m){return double(m.buffersReady.load());});
+    w.portFamily("pothos_port_buffers", "gauge", "Output buffers configured for the port.", OUTPUT,
+        [](const PortMetrics &m){return double(m.buffersTotal.load());});
+
+    return w.ss.str();
+}
+
+/***********************************************************************
+ * HTTP server
+ **********************************************************************/
+class MetricsRequestHandler : public Poco::Net::HTTPRequestHandler
+{
+public:
+    void handleRequest(Poco::Net::HTTPServerRequest &request, Poco::Net::HTTPServerResponse &response)
+    {
+        if (request.getURI() != "/metrics")
+        {
+            response.setStatusAndReason(Poco::Net::HTTPResponse::HTTP_NOT_FOUND);
+            response.send() << "use /metrics\n";
+            return;
+        }
+        const auto text = Pothos::MetricsServer::getMetricsText();
+        response.setContentType("text/plain; version=0.0.4");
+        response.setContentLength(text.size());
+        response.send() << text;
+    }
+};
+
+class MetricsRequestHandlerFactory : public Poco::Net::HTTPRequestHandlerFactory
+{
+public:
+    Poco::Net::HTTPRequestHandler *createRequestHandler(const Poco::Net::HTTPServerRequest &)
+    {
+        return new MetricsRequestHandler();
+    }
+};
+
+//bind without address reuse, so that a port that is in use is an error
+static Poco::Net::ServerSocket makeServerSocket(const unsigned short port)
+{
+    Poco::Net::ServerSocket socket;
+    socket.bind(Poco::Net::SocketAddress(port), false);
+    socket.listen();
+    return socket;
+}
+
+struct Pothos::MetricsServer::Impl
+{
+    Impl(const unsigned short port):
+        server(new MetricsRequestHandlerFactory(), makeServerSocket(port), new Poco::Net::HTTPServerParams())
+    {
+        server.start();
+        enableWorkerMetrics(true);
+    }
+
+    ~Impl(void)
+    {
+        enableWorkerMetrics(false);
+        server.stop();
+    }
+
+    Poco::Net::HTTPServer server;
+};
+
+Pothos::MetricsServer::MetricsServer(const unsigned short port)
+{
+    try
+    {
+        _impl.reset(new Impl(port));
+    }
+    catch (const Poco::Exception &ex)
+    {
+        throw Pothos::MetricsServerError("Pothos::MetricsServer("+std::to_string(port)+")", ex.displayText());
+    }
+}
+
+Pothos::MetricsServer::~MetricsServer(void)
+{
+    return;
+}
+
+unsigned short Pothos::MetricsServer::getPort(void) const
+{
+    return _impl->server.port();
+}
@@ -12,7 +12,7 @@ Pothos::OutputPort::OutputPort(OutputPortImpl *impl):
     _totalMessages(0),
     _pendingElements(0)
 {
-    _impl->bufferManager = BufferManager::make("generic", BufferManagerArgs());
+    return;
 }
 
 Pothos::OutputPort::~OutputPort(void)
@@ -30,7 +30,10 @@ void Pothos::OutputPort::postLabel(const Label &label)
 {
     assert(_impl);
     assert(_impl->actor != nullptr);
-    _impl->actor->sendPortMessage(_impl->subscribers, label);
+    _impl->stats.totalLabels++;
+    _impl->stats.ticksLastLabel = Theron::Detail::Clock::GetTicks();
+    if (_impl->actor->inWork) _impl->postedLabels.push_back(label);
+    else _impl->actor->sendPortMessage(_impl->subscribers, label);
 }
 
 void Pothos::OutputPort::postMessage(const Object &message)
@@ -49,6 +52,38 @@ void Pothos::OutputPort::postBuffer(const BufferChunk &buffer)
     queue.push_back(buffer);
 }
 
+void Pothos::OutputPort::postEndOfStream(void)
+{
+    assert(_impl);
+    assert(_impl->actor != nullptr);
+    _impl->endOfStream = true;
+    if (_impl->actor->inWork) return;
+    _impl->actor->sendEndOfStream(*_impl);
+    _impl->actor->updateEndOfStream(false);
+}
+
+void Pothos::OutputPort::setBufferManager(const std::string &name, const BufferManagerArgs &args)
+{
+    assert(_impl);
+    assert(_impl->actor != nullptr);
+    if (_impl->actor->active) throw PortAccessError("Pothos::OutputPort::setBufferManager()", "block is active");
+    _impl->actor->changeBufferManager(*this, name, args);
+    _impl->bufferManagerCustom = true;
+}
+
+void Pothos::OutputPort::setReadBeforeWrite(InputPort *input)
+{
+    assert(_impl);
+    if (input != nullptr and input->dtype().size() < this->dtype().size())
+    {
+        throw PortAccessError("Pothos::OutputPort::setReadBeforeWrite("+input->name()+")",
+            "output element size exceeds the input element size");
+    }
+    if (_impl->readBeforeWrite != nullptr) _impl->readBeforeWrite->_impl->readBeforeWrite = false;
+    _impl->readBeforeWrite = input;
+    if (input != nullptr) input->_impl->readBeforeWrite = true;
+}
+
 #include <Pothos/Managed.hpp>
 
 static auto managedOutputPort = Pothos::ManagedClass()
@@ -65,4 +100,7 @@ static auto managedOutputPort = Pothos::ManagedClass()
     .registerMethod(POTHOS_FCN_TUPLE(Pothos::OutputPort, postLabel))
     .registerMethod(POTHOS_FCN_TUPLE(Pothos::OutputPort, postMessage))
     .registerMethod(POTHOS_FCN_TUPLE(Pothos::OutputPort, postBuffer))
+    .registerMethod(POTHOS_FCN_TUPLE(Pothos::OutputPort, postEndOfStream))
+    .registerMethod(POTHOS_FCN_TUPLE(Pothos::OutputPort, setBufferManager))
+    .registerMethod(POTHOS_FCN_TUPLE(Pothos::OutputPort, setReadBeforeWrite))
     .commit("Pothos/OutputPort");
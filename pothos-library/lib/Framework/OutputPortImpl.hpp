@@ -3,16 +3,39 @@
 
 #pragma once
 #include "Framework/PortSubscriber.hpp"
+#include "Framework/WorkerStats.hpp"
 #include <Pothos/Framework/OutputPort.hpp>
 #include <Pothos/Framework/BufferManager.hpp>
 #include <Pothos/Util/RingDeque.hpp>
 #include <vector>
+#include <string>
 
 class Pothos::OutputPortImpl
 {
 public:
+    OutputPortImpl(void):
+        bufferManagerName("generic"),
+        bufferManagerCustom(false),
+        readBeforeWrite(nullptr),
+        bufferFromInput(false),
+        endOfStream(false),
+        endOfStreamSent(false),
+        actor(nullptr)
+    {
+        return;
+    }
+
     BufferManager::Sptr bufferManager;
+    std::string bufferManagerName;
+    BufferManagerArgs bufferManagerArgs;
+    bool bufferManagerCustom; //set by the user, not negotiated
+    InputPort *readBeforeWrite; //in-place buffer source or nullptr
+    bool bufferFromInput; //the current buffer came from readBeforeWrite
     Util::RingDeque<BufferChunk> postedBuffers;
+    std::vector<Label> postedLabels; //sent with the next stream buffer
     std::vector<PortSubscriber> subscribers;
+    bool endOfStream; //posted, sent after the buffers of this work() call
+    bool endOfStreamSent;
+    PortStats stats;
     WorkerActor *actor;
 };
@@ -7,14 +7,20 @@
 #include <Theron/Framework.h>
 #include <string>
 
+namespace Pothos { class WorkerActor; }
+
 struct PortSubscriber
 {
     PortSubscriber(void):
-        index(-1)
+        index(-1),
+        localActor(nullptr),
+        fusedActor(nullptr)
     {}
     int index; //port number
     std::string name; //port name
     Theron::Address address;
+    Pothos::WorkerActor *localActor; //receives stream data by delivery when in-process
+    Pothos::WorkerActor *fusedActor; //handles messages by direct call when fused
 };
 
 inline bool operator==(const PortSubscriber &lhs, const PortSubscriber &rhs)
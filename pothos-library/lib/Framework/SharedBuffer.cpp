@@ -4,6 +4,9 @@
 #include <Pothos/Framework/SharedBuffer.hpp>
 #include <Pothos/Framework/Exception.hpp>
 #include <mutex>
+#include <vector>
+#include <algorithm> //min, max
+#include <new> //operator new
 #include <Poco/SingletonHolder.h>
 
 Pothos::SharedBuffer::SharedBuffer(void):
@@ -30,6 +33,227 @@ Pothos::SharedBuffer::SharedBuffer(const size_t address, const size_t length, co
     }
 }
 
+/***********************************************************************
+ * Slab pool for small generic buffers:
+ * Slabs are grouped into power of two size classes.
+ * Each thread caches free slabs of every class, and a bounded
+ * central depot balances the caches when buffers are freed
+ * on a different thread than the one which allocated them.
+ * A slab holds the shared_ptr control block in its header,
+ * so that a recycled buffer needs no allocation at all.
+ **********************************************************************/
+#define SLAB_ALIGNMENT_BYTES 64
+#define SLAB_HEADER_BYTES 64
+
+//thread_local with destructors is missing before MSVC 2015
+#if !defined(_MSC_VER) || _MSC_VER >= 1900
+#define SLAB_THREAD_CACHE 1
+#endif
+
+static const size_t SLAB_MIN_CLASS_BITS = 6; //64 bytes
+static const size_t SLAB_NUM_CLASSES = 11; //up to 64 KiB
+static const size_t SLAB_CACHE_BYTES = 256*1024; //per class and thread
+static const size_t SLAB_CACHE_MAX = 64; //slabs per class and thread
+static const size_t SLAB_DEPOT_FACTOR = 4; //depot to thread cache limit
+
+static size_t slabClassBytes(const size_t sizeClass)
+{
+    return size_t(1) << (sizeClass+SLAB_MIN_CLASS_BITS);
+}
+
+static size_t slabCacheLimit(const size_t sizeClass)
+{
+    return std::min(SLAB_CACHE_MAX, std::max<size_t>(2, SLAB_CACHE_BYTES/slabClassBytes(sizeClass)));
+}
+
+static char *slabHeader(char *raw)
+{
+    const size_t addr = size_t(raw) + SLAB_ALIGNMENT_BYTES - 1;
+    return reinterpret_cast<char *>(addr - (addr % SLAB_ALIGNMENT_BYTES));
+}
+
+static char *slabNew(const size_t sizeClass)
+{
+    return new char[SLAB_HEADER_BYTES + slabClassBytes(sizeClass) + SLAB_ALIGNMENT_BYTES - 1];
+}
+
+struct SlabDepot
+{
+    std::mutex mutex[SLAB_NUM_CLASSES];
+    std::vector<char *> freeSlabs[SLAB_NUM_CLASSES];
+
+    //move up to num slabs from the depot into the list
+    void take(const size_t sizeClass, std::vector<char *> &slabs, const size_t num)
+    {
+        std::lock_guard<std::mutex> lock(mutex[sizeClass]);
+        auto &depot = freeSlabs[sizeClass];
+        const size_t n = std::min(num, depot.size());
+        slabs.insert(slabs.end(), depot.end()-n, depot.end());
+        depot.resize(depot.size()-n);
+    }
+
+    //move slabs from the back of the list into the depot, free what does not fit
+    void give(const size_t sizeClass, std::vector<char *> &slabs, const size_t num)
+    {
+        const size_t limit = SLAB_DEPOT_FACTOR*slabCacheLimit(sizeClass);
+        std::lock_guard<std::mutex> lock(mutex[sizeClass]);
+        auto &depot = freeSlabs[sizeClass];
+        for (size_t i = 0; i < num; i++)
+        {
+            if (depot.size() < limit) depot.push_back(slabs.back());
+            else delete [] slabs.back();
+            slabs.pop_back();
+        }
+    }
+};
+
+static SlabDepot &getSlabDepot(void)
+{
+    //never destroyed: buffers may be freed during static destruction
+    static SlabDepot *depot = new SlabDepot();
+    return *depot;
+}
+
+#ifdef SLAB_THREAD_CACHE
+struct SlabThreadCache
+{
+    std::vector<char *> freeSlabs[SLAB_NUM_CLASSES];
+    ~SlabThreadCache(void);
+};
+
+static thread_local SlabThreadCache slabThreadCache;
+static thread_local bool slabThreadCacheDone = false;
+
+SlabThreadCache::~SlabThreadCache(void)
+{
+    slabThreadCacheDone = true;
+    for (size_t i = 0; i < SLAB_NUM_CLASSES; i++)
+    {
+        getSlabDepot().give(i, freeSlabs[i], freeSlabs[i].size());
+    }
+}
+#endif //SLAB_THREAD_CACHE
+
+static char *slabAlloc(const size_t sizeClass)
+{
+    #ifdef SLAB_THREAD_CACHE
+    if (not slabThreadCacheDone)
+    {
+        auto &cache = slabThreadCache.freeSlabs[sizeClass];
+        if (cache.empty()) getSlabDepot().take(sizeClass, cache, slabCacheLimit(sizeClass)/2);
+        if (cache.empty()) return slabNew(sizeClass);
+        char *raw = cache.back();
+        cache.pop_back();
+        return raw;
+    }
+    #endif //SLAB_THREAD_CACHE
+
+    std::vector<char *> slabs;
+    getSlabDepot().take(sizeClass, slabs, 1);
+    if (slabs.empty()) return slabNew(sizeClass);
+    return slabs.back();
+}
+
+static void slabFree(const size_t sizeClass, char *raw)
+{
+    #ifdef SLAB_THREAD_CACHE
+    if (not slabThreadCacheDone)
+    {
+        auto &cache = slabThreadCache.freeSlabs[sizeClass];
+        cache.push_back(raw);
+        const size_t limit = slabCacheLimit(sizeClass);
+        if (cache.size() > limit) getSlabDepot().give(sizeClass, cache, cache.size()-limit/2);
+        return;
+    }
+    #endif //SLAB_THREAD_CACHE
+
+    std::vector<char *> slabs(1, raw);
+    getSlabDepot().give(sizeClass, slabs, 1);
+}
+
+/*!
+ * Allocates the shared_ptr control block in the slab header.
+ * Deallocation of the control block is the last access to the slab,
+ * which makes it the point where the slab is recycled into the pool.
+ */
+template <typename T>
+struct SlabHeaderAllocator
+{
+    typedef T value_type;
+
+    template <typename U>
+    struct rebind
+    {
+        typedef SlabHeaderAllocator<U> other;
+    };
+
+    SlabHeaderAllocator(char *raw, const size_t sizeClass):
+        raw(raw), sizeClass(sizeClass)
+    {
+        return;
+    }
+
+    template <typename U>
+    SlabHeaderAllocator(const SlabHeaderAllocator<U> &other):
+        raw(other.raw), sizeClass(other.sizeClass)
+    {
+        return;
+    }
+
+    T *allocate(const size_t n)
+    {
+        if (n*sizeof(T) <= SLAB_HEADER_BYTES) return reinterpret_cast<T *>(slabHeader(raw));
+        return static_cast<T *>(::operator new(n*sizeof(T)));
+    }
+
+    void deallocate(T *p, const size_t)
+    {
+        if (reinterpret_cast<char *>(p) != slabHeader(raw)) ::operator delete(p);
+        slabFree(sizeClass, raw);
+    }
+
+    char *raw;
+    size_t sizeClass;
+};
+
+template <typename T, typename U>
+bool operator==(const SlabHeaderAllocator<T> &lhs, const SlabHeaderAllocator<U> &rhs)
+{
+    return lhs.raw == rhs.raw;
+}
+
+template <typename T, typename U>
+bool operator!=(const SlabHeaderAllocator<T> &lhs, const SlabHeaderAllocator<U> &rhs)
+{
+    return lhs.raw != rhs.raw;
+}
+
+struct SlabNoDelete
+{
+    void operator()(void *) const
+    {
+        return;
+    }
+};
+
+Pothos::SharedBuffer Pothos::SharedBuffer::make(const size_t numBytes, const long nodeAffinity)
+{
+    //numa allocations and large buffers are not pooled
+    if (nodeAffinity >= 0 or numBytes > slabClassBytes(SLAB_NUM_CLASSES-1))
+    {
+        return SharedBuffer::makeUnpooled(numBytes, nodeAffinity);
+    }
+
+    //find the smallest class that holds the requested bytes
+    size_t sizeClass = 0;
+    while (slabClassBytes(sizeClass) < numBytes) sizeClass++;
+
+    char *raw = slabAlloc(sizeClass);
+    char *payload = slabHeader(raw) + SLAB_HEADER_BYTES;
+    std::shared_ptr<void> container(payload, SlabNoDelete(), SlabHeaderAllocator<char>(raw, sizeClass));
+    return SharedBuffer(size_t(payload), numBytes, container);
+}
+
 static std::mutex &getCircMutex(void)
 {
     static Poco::SingletonHolder<std::mutex> sh;
@@ -10,7 +10,9 @@
 #include <unistd.h> //close
 #include <cerrno> //errno
 #include <cstring> //strerror
-#include <sys/mman.h> //mmap
+#include <sys/mman.h> //mmap, shm_open
+#include <sys/syscall.h> //SYS_memfd_create
+#include <atomic>
 
 //MAP_ANON is deprecated - this supports older headers
 #ifndef MAP_ANONYMOUS
@@ -87,12 +89,102 @@ private:
 };
 
 /***********************************************************************
- * numa allocator for an affinitized memory slab
+ * huge page allocator for a large memory slab
+ **********************************************************************/
+#define HUGE_PAGE_BYTES (2*1024*1024)
+
+class HugeBufferContainer
+{
+public:
+    HugeBufferContainer(const size_t numBytes, const long nodeAffinity):
+        _mem(MAP_FAILED),
+        _len(0),
+        _address(0)
+    {
+        const size_t hugeBytes = ((numBytes + HUGE_PAGE_BYTES - 1)/HUGE_PAGE_BYTES)*HUGE_PAGE_BYTES;
+
+        //explicit huge pages from the reserved pool
+        #ifdef MAP_HUGETLB
+        _mem = mmap(nullptr, hugeBytes, PROT_READ | PROT_WRITE,
+            MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, off_t(0));
+        if (_mem != MAP_FAILED)
+        {
+            _len = hugeBytes;
+            _address = size_t(_mem);
+        }
+        #endif
+
+        //transparent huge pages over a region aligned to the huge page size
+        if (_mem == MAP_FAILED)
+        {
+            _mem = mmap(nullptr, hugeBytes + HUGE_PAGE_BYTES, PROT_READ | PROT_WRITE,
+                MAP_PRIVATE | MAP_ANONYMOUS, -1, off_t(0));
+            if (_mem == MAP_FAILED) return;
+            _len = hugeBytes + HUGE_PAGE_BYTES;
+            _address = ((size_t(_mem) + HUGE_PAGE_BYTES - 1)/HUGE_PAGE_BYTES)*HUGE_PAGE_BYTES;
+            #ifdef MADV_HUGEPAGE
+            madvise((void *)_address, hugeBytes, MADV_HUGEPAGE);
+            #endif
+        }
+
+        //bind the pages before they are touched
+        #if THERON_NUMA
+        if (nodeAffinity >= 0 and numa_available() != -1) numa_tonode_memory((void *)_address, hugeBytes, nodeAffinity);
+        #else
+        (void)nodeAffinity;
+        #endif
+    }
+
+    ~HugeBufferContainer(void)
+    {
+        if (_mem != MAP_FAILED) munmap(_mem, _len);
+    }
+
+    size_t getAddress(void) const
+    {
+        return _address;
+    }
+
+private:
+    void *_mem;
+    size_t _len;
+    size_t _address;
+};
+
+/***********************************************************************
+ * anonymous shared memory for the circular buffer's physical pages
+ **********************************************************************/
+static int openAnonymousMemory(std::string &tmpFile)
+{
+    //a memory file that is never visible in a filesystem
+    int fd = -1;
+    #if defined(__linux__) && defined(SYS_memfd_create)
+    fd = int(syscall(SYS_memfd_create, "pothos_circ", 1/*MFD_CLOEXEC*/));
+    if (fd >= 0) return fd;
+    #endif
+
+    //a posix shared memory object, unlinked right away
+    static std::atomic<unsigned> count(0);
+    const auto shmName = Poco::format("/pothos_circ_%d_%u", int(getpid()), count++);
+    fd = shm_open(shmName.c_str(), O_RDWR | O_CREAT | O_EXCL, S_IRUSR | S_IWUSR);
+    if (fd >= 0)
+    {
+        shm_unlink(shmName.c_str());
+        return fd;
+    }
+
+    //a temporary file on disk, unlinked when the container is cleaned up
+    tmpFile = Poco::TemporaryFile::tempName();
+    return open(tmpFile.c_str(), O_RDWR | O_CREAT | O_EXCL, S_IRUSR | S_IWUSR);
+}
+
+/***********************************************************************
+ * double mapped allocator for a circular memory slab
  **********************************************************************/
 class CircularBufferContainer
 {
 public:
-    CircularBufferContainer(const size_t numBytes);
+    CircularBufferContainer(const size_t numBytes, const long nodeAffinity);
     ~CircularBufferContainer(void)
     {
         this->cleanup();
@@ -113,6 +205,14 @@ private:
             Poco::format("errno %d - %s", errnoSave, std::string(strerror(errnoSave))));
     }
 
+    void closeFd(void)
+    {
+        if (memFd >= 0) close(memFd);
+        memFd = -1;
+        if (not tmpFile.empty()) unlink(tmpFile.c_str());
+        tmpFile.clear();
+    }
+
     void cleanup(void)
     {
         if (mapPtr1 != MAP_FAILED) munmap(mapPtr1, _numBytes);
@@ -121,43 +221,34 @@ private:
         if (mapPtr0 != MAP_FAILED) munmap(mapPtr0, _numBytes);
         mapPtr0 = MAP_FAILED;
 
-        if (tmpFd < 0)
-        {
-            close(tmpFd);
-            unlink(tmpFile.c_str());
-        }
-        tmpFd = -1;
+        this->closeFd();
     }
 
     const size_t _numBytes;
     void *virtualAddr2X;
     std::string tmpFile;
-    int tmpFd;
+    int memFd;
     void *mapPtr0;
     void *mapPtr1;
 };
 
-CircularBufferContainer::CircularBufferContainer(const size_t numBytes):
+CircularBufferContainer::CircularBufferContainer(const size_t numBytes, const long nodeAffinity):
     _numBytes(numBytes),
     virtualAddr2X(nullptr),
-    tmpFd(-1),
+    memFd(-1),
     mapPtr0(MAP_FAILED),
     mapPtr1(MAP_FAILED)
 {
     int ret = 0;
 
     /*******************************************************************
-     * Step 1) open a temp file for physical memory
+     * Step 1) open anonymous shared memory for physical memory
      ******************************************************************/
-    tmpFile = Poco::TemporaryFile::tempName();
-    tmpFd = open(
-        tmpFile.c_str(),
-        O_RDWR | O_CREAT | O_EXCL,
-        S_IRUSR | S_IWUSR);
-    if (tmpFd < 0) this->errorOut("open("+ tmpFile +")");
+    memFd = openAnonymousMemory(tmpFile);
+    if (memFd < 0) this->errorOut("openAnonymousMemory()");
 
-    ret = ftruncate(tmpFd, numBytes*2);
-    if (ret != 0) this->errorOut("ftruncate("+ tmpFile +")");
+    ret = ftruncate(memFd, numBytes);
+    if (ret != 0) this->errorOut("ftruncate()");
 
     /*******************************************************************
      * Step 2) find a 2X chunk of virtual memory
@@ -181,7 +272,7 @@ CircularBufferContainer::CircularBufferContainer(const size_t numBytes):
         numBytes,
         PROT_READ | PROT_WRITE,
         MAP_SHARED,
-        tmpFd, off_t(0));
+        memFd, off_t(0));
     if (mapPtr0 == MAP_FAILED) this->errorOut("mmap(0)");
 
     mapPtr1 = mmap(
@@ -189,14 +280,26 @@ CircularBufferContainer::CircularBufferContainer(const size_t numBytes):
         numBytes,
         PROT_READ | PROT_WRITE,
         MAP_SHARED,
-        tmpFd, off_t(0));
+        memFd, off_t(0));
     if (mapPtr1 == MAP_FAILED) this->errorOut("mmap(1)");
+
+    /*******************************************************************
+     * Step 4) the mappings hold the memory, release the descriptor
+     ******************************************************************/
+    this->closeFd();
+
+    //bind the shared pages before they are touched
+    #if THERON_NUMA
+    if (nodeAffinity >= 0 and numa_available() != -1) numa_tonode_memory(mapPtr0, numBytes, nodeAffinity);
+    #else
+    (void)nodeAffinity;
+    #endif
 }
 
 /***********************************************************************
  * shared buffer implementation
  **********************************************************************/
-Pothos::SharedBuffer Pothos::SharedBuffer::make(const size_t numBytes, const long nodeAffinity)
+Pothos::SharedBuffer Pothos::SharedBuffer::makeUnpooled(const size_t numBytes, const long nodeAffinity)
 {
     size_t address = 0;
     std::shared_ptr<void> deleter;
@@ -220,9 +323,20 @@ Pothos::SharedBuffer Pothos::SharedBuffer::make(const size_t numBytes, const lon
     return SharedBuffer(address, numBytes, deleter);
 }
 
-Pothos::SharedBuffer Pothos::SharedBuffer::makeCircUnprotected(const size_t numBytesIn, const long)
+Pothos::SharedBuffer Pothos::SharedBuffer::makeHuge(const size_t numBytes, const long nodeAffinity)
+{
+    std::shared_ptr<HugeBufferContainer> container(new HugeBufferContainer(numBytes, nodeAffinity));
+
+    //address is 0 when the mapping fails, use the generic allocation
+    if (container->getAddress() == 0) return SharedBuffer::make(numBytes, nodeAffinity);
+
+    const size_t hugeBytes = ((numBytes + HUGE_PAGE_BYTES - 1)/HUGE_PAGE_BYTES)*HUGE_PAGE_BYTES;
+    return SharedBuffer(container->getAddress(), hugeBytes, container);
+}
+
+Pothos::SharedBuffer Pothos::SharedBuffer::makeCircUnprotected(const size_t numBytesIn, const long nodeAffinity)
 {
     const size_t numBytes = ((numBytesIn + getpagesize() - 1)/getpagesize())*getpagesize();
-    std::shared_ptr<CircularBufferContainer> container(new CircularBufferContainer(numBytes));
+    std::shared_ptr<CircularBufferContainer> container(new CircularBufferContainer(numBytes, nodeAffinity));
     return SharedBuffer(container->getAddress(), numBytes, container);
 }
@@ -175,12 +175,18 @@ CircularBufferContainer::CircularBufferContainer(const size_t numBytes, const lo
 /***********************************************************************
  * shared buffer factory functions
  **********************************************************************/
-Pothos::SharedBuffer Pothos::SharedBuffer::make(const size_t numBytes, const long nodeAffinity)
+Pothos::SharedBuffer Pothos::SharedBuffer::makeUnpooled(const size_t numBytes, const long nodeAffinity)
 {
     std::shared_ptr<GenericBufferContainer> container(new GenericBufferContainer(numBytes, nodeAffinity));
     return SharedBuffer(container->getAddress(), numBytes, container);
 }
 
+Pothos::SharedBuffer Pothos::SharedBuffer::makeHuge(const size_t numBytes, const long nodeAffinity)
+{
+    //large pages require the SeLockMemoryPrivilege, use the generic allocation
+    return SharedBuffer::make(numBytes, nodeAffinity);
+}
+
 Pothos::SharedBuffer Pothos::SharedBuffer::makeCircUnprotected(const size_t numBytesIn, const long nodeAffinity)
 {
     const size_t numBytes = ((numBytesIn + getregionsize() - 1)/getregionsize())*getregionsize();
@@ -0,0 +1,316 @@
+// Copyright (c) 2014-2014 Josh Blum
+// SPDX-License-Identifier: BSL-1.0
+
+#include <Pothos/Framework/ThreadPool.hpp>
+#include <Pothos/Framework/Exception.hpp>
+#include <Theron/Actor.h>
+#include <Theron/Framework.h>
+#include <Poco/Environment.h>
+#include <Poco/NumberParser.h>
+#include <Poco/Exception.h>
+#include <Poco/Mutex.h>
+#include <Poco/DirectoryIterator.h>
+#include <algorithm> //max
+
+/***********************************************************************
+ * ThreadPoolArgs implementation
+ **********************************************************************/
+Pothos::ThreadPoolArgs::ThreadPoolArgs(void):
+    numThreads(0),
+    threadPerBlock(false),
+    workStealing(false),
+    yieldMode("CONDITION"),
+    backoffSpinCount(20),
+    backoffYieldCount(20),
+    backoffSleepMs(1),
+    priority(0.0),
+    affinityMode("ALL")
+{
+    return;
+}
+
+Pothos::ThreadPoolArgs::ThreadPoolArgs(const size_t numThreads):
+    numThreads(numThreads),
+    threadPerBlock(false),
+    workStealing(false),
+    yieldMode("CONDITION"),
+    backoffSpinCount(20),
+    backoffYieldCount(20),
+    backoffSleepMs(1),
+    priority(0.0),
+    affinityMode("ALL")
+{
+    return;
+}
+
+/***********************************************************************
+ * Helpers for the yield mode
+ **********************************************************************/
+static Theron::YieldStrategy getYieldStrategy(const std::string &mode)
+{
+    if (mode == "CONDITION") return Theron::YIELD_STRATEGY_CONDITION;
+    if (mode == "HYBRID") return Theron::YIELD_STRATEGY_HYBRID;
+    if (mode == "SPIN") return Theron::YIELD_STRATEGY_SPIN;
+    if (mode == "BACKOFF") return Theron::YIELD_STRATEGY_BACKOFF;
+    throw Pothos::ThreadPoolError("Pothos::ThreadPool()", "unknown yield mode: " + mode);
+}
+
+/***********************************************************************
+ * Helpers for thread affinity
+ **********************************************************************/
+static long getNodeOfProcessor(const size_t cpu)
+{
+    //the sysfs cpu directory contains a link to its NUMA node
+    try
+    {
+        const Poco::DirectoryIterator end;
+        for (Poco::DirectoryIterator it("/sys/devices/system/cpu/cpu" + std::to_string(cpu)); it != end; ++it)
+        {
+            const auto &name = it.name();
+            if (name.size() <= 4 or name.substr(0, 4) != "node") continue;
+            return long(Poco::NumberParser::parseUnsigned(name.substr(4)));
+        }
+    }
+    catch (const Poco::Exception &)
+    {
+        //no sysfs on this system, the node is unknown
+    }
+    return -1;
+}
+
+#if THERON_NUMA
+static size_t getNodeLocalIndex(const size_t cpu, const long node)
+{
+    //the processors of a node are indexed in order of their absolute index
+    size_t index = 0;
+    for (size_t other = 0; other < cpu; other++)
+    {
+        if (getNodeOfProcessor(other) == node) index++;
+    }
+    return index;
+}
+#endif //THERON_NUMA
+
+static void setupAffinity(const Pothos::ThreadPoolArgs &args, Theron::Framework::Parameters &params)
+{
+    if (args.affinityMode == "ALL") return;
+    if (args.affinityMode != "CPU" and args.affinityMode != "NUMA") throw Pothos::ThreadPoolError(
+        "Pothos::ThreadPool()", "unknown affinity mode: " + args.affinityMode);
+    if (args.affinity.empty()) throw Pothos::ThreadPoolError(
+        "Pothos::ThreadPool()", "empty affinity list for mode " + args.affinityMode);
+
+    uint32_t mask = 0;
+    for (const auto index : args.affinity)
+    {
+        if (index >= 32) throw Pothos::ThreadPoolError(
+            "Pothos::ThreadPool()", "affinity index out of range: " + std::to_string(index));
+        mask |= uint32_t(1) << index;
+    }
+
+    //CPU mode selects processors by their absolute index
+    if (args.affinityMode == "CPU")
+    {
+        #if THERON_NUMA
+        //the NUMA build selects processors relative to each node in the node mask,
+        //so map each absolute processor to its node and its index within that node;
+        //the processor mask applies to every selected node, so processors listed
+        //from several nodes may pin the threads to a superset of the list
+        params.mNodeMask = 0;
+        params.mProcessorMask = 0;
+        for (const auto cpu : args.affinity)
+        {
+            const long node = getNodeOfProcessor(cpu);
+            const size_t local = getNodeLocalIndex(cpu, node);
+            if (node >= 32 or local >= 32) throw Pothos::ThreadPoolError(
+                "Pothos::ThreadPool()", "affinity index out of range: " + std::to_string(cpu));
+            params.mNodeMask |= uint32_t(1) << std::max(node, 0L);
+            params.mProcessorMask |= uint32_t(1) << local;
+        }
+        #else
+        params.mNodeMask = 1;
+        params.mProcessorMask = mask;
+        #endif //THERON_NUMA
+    }
+
+    //NUMA mode selects all processors on the listed nodes
+    if (args.affinityMode == "NUMA")
+    {
+        params.mNodeMask = mask;
+        params.mProcessorMask = ~uint32_t(0);
+    }
+}
+
+static long getArgsNodeAffinity(const Pothos::ThreadPoolArgs &args)
+{
+    if (args.affinityMode == "NUMA" and args.affinity.size() == 1) return long(args.affinity.front());
+    if (args.affinityMode != "CPU" or args.affinity.empty()) return -1;
+
+    //all of the processors must reside on the same node
+    const long node = getNodeOfProcessor(args.affinity.front());
+    for (const auto cpu : args.affinity)
+    {
+        if (getNodeOfProcessor(cpu) != node) return -1;
+    }
+    return node;
+}
+
+/***********************************************************************
+ * ThreadPool implementation
+ **********************************************************************/
+struct Pothos::ThreadPool::Impl
+{
+    ThreadPoolArgs args;
+    Theron::Framework::Parameters params;
+    long nodeAffinity;
+    std::shared_ptr<Theron::Framework> framework;
+};
+
+Pothos::ThreadPool::ThreadPool(void)
+{
+    return;
+}
+
+Pothos::ThreadPool::ThreadPool(const ThreadPoolArgs &args):
+    _impl(new Impl())
+{
+    if (args.priority < -1.0 or args.priority > 1.0) throw ThreadPoolError(
+        "Pothos::ThreadPool()", "priority out of range [-1.0, 1.0]");
+    if (args.backoffSleepMs >= 1000) throw ThreadPoolError(
+        "Pothos::ThreadPool()", "backoff sleep out of range [0, 1000) ms");
+
+    _impl->args = args;
+    _impl->params.mThreadCount = uint32_t(args.numThreads);
+    _impl->params.mThreadPriority = float(args.priority);
+    _impl->params.mWorkStealing = args.workStealing;
+    _impl->params.mYieldStrategy = getYieldStrategy(args.yieldMode);
+    _impl->params.mBackoffSpinCount = uint32_t(args.backoffSpinCount);
+    _impl->params.mBackoffYieldCount = uint32_t(args.backoffYieldCount);
+    _impl->params.mBackoffSleepMilliseconds = uint32_t(args.backoffSleepMs);
+    setupAffinity(args, _impl->params);
+    _impl->nodeAffinity = getArgsNodeAffinity(args);
+
+    //one thread per block mode: each block makes its own framework
+    if (args.threadPerBlock)
+    {
+        _impl->params.mThreadCount = 1;
+        return;
+    }
+
+    //use a minimum of two threads so blocks that handshake with each other
+    //in activate() or deactivate() can still make progress on single-core systems
+    if (_impl->params.mThreadCount == 0) _impl->params.mThreadCount = std::max(2u, Poco::Environment::processorCount());
+    _impl->framework.reset(new Theron::Framework(_impl->params));
+}
+
+static Pothos::ThreadPoolArgs getDefaultThreadPoolArgs(void)
+{
+    Pothos::ThreadPoolArgs args;
+    try
+    {
+        if (Poco::Environment::has("POTHOS_NUM_THREADS"))
+        {
+            args.numThreads = Poco::NumberParser::parseUnsigned(Poco::Environment::get("POTHOS_NUM_THREADS"));
+        }
+        if (Poco::Environment::has("POTHOS_THREAD_PER_BLOCK"))
+        {
+            args.threadPerBlock = Poco::NumberParser::parseBool(Poco::Environment::get("POTHOS_THREAD_PER_BLOCK"));
+        }
+        if (Poco::Environment::has("POTHOS_YIELD_MODE"))
+        {
+            args.yieldMode = Poco::Environment::get("POTHOS_YIELD_MODE");
+        }
+    }
+    catch (const Poco::SyntaxException &ex)
+    {
+        throw Pothos::ThreadPoolError("Pothos::ThreadPool::getDefault()", ex.displayText());
+    }
+    return args;
+}
+
+Pothos::ThreadPool Pothos::ThreadPool::getDefault(void)
+{
+    static Poco::FastMutex mutex;
+    Poco::FastMutex::ScopedLock lock(mutex);
+
+    //the default pool lives as long as a block holds a reference
+    static std::weak_ptr<Impl> defaultImpl;
+    ThreadPool pool;
+    pool._impl = defaultImpl.lock();
+    if (pool.null())
+    {
+        pool = ThreadPool(getDefaultThreadPoolArgs());
+        defaultImpl = pool._impl;
+    }
+    return pool;
+}
+
+const Pothos::ThreadPoolArgs &Pothos::ThreadPool::getArgs(void) const
+{
+    if (this->null()) throw ThreadPoolError("Pothos::ThreadPool::getArgs()", "null thread pool");
+    return _impl->args;
+}
+
+long Pothos::ThreadPool::getNodeAffinity(void) const
+{
+    if (this->null()) throw ThreadPoolError("Pothos::ThreadPool::getNodeAffinity()", "null thread pool");
+    return _impl->nodeAffinity;
+}
+
+std::shared_ptr<void> Pothos::ThreadPool::getContainer(void) const
+{
+    if (this->null()) return std::shared_ptr<void>();
+    if (_impl->args.threadPerBlock) return std::make_shared<Theron::Framework>(_impl->params);
+    return _impl->framework;
+}
+
+bool Pothos::operator==(const ThreadPool &lhs, const ThreadPool &rhs)
+{
+    return lhs._impl == rhs._impl;
+}
+
+#include <Pothos/Managed.hpp>
+
+static auto managedThreadPoolArgs = Pothos::ManagedClass()
+    .registerConstructor<Pothos::ThreadPoolArgs>()
+    .registerConstructor<Pothos::ThreadPoolArgs, const size_t>()
+    .registerField(POTHOS_FCN_TUPLE(Pothos::ThreadPoolArgs, numThreads))
+    .registerField(POTHOS_FCN_TUPLE(Pothos::ThreadPoolArgs, threadPerBlock))
+    .registerField(POTHOS_FCN_TUPLE(Pothos::ThreadPoolArgs, workStealing))
+    .registerField(POTHOS_FCN_TUPLE(Pothos::ThreadPoolArgs, yieldMode))
+    .registerField(POTHOS_FCN_TUPLE(Pothos::ThreadPoolArgs, backoffSpinCount))
+    .registerField(POTHOS_FCN_TUPLE(Pothos::ThreadPoolArgs, backoffYieldCount))
+    .registerField(POTHOS_FCN_TUPLE(Pothos::ThreadPoolArgs, backoffSleepMs))
+    .registerField(POTHOS_FCN_TUPLE(Pothos::ThreadPoolArgs, priority))
+    .registerField(POTHOS_FCN_TUPLE(Pothos::ThreadPoolArgs, affinityMode))
+    .registerField(POTHOS_FCN_TUPLE(Pothos::ThreadPoolArgs, affinity))
+    .commit("Pothos/ThreadPoolArgs");
+
+static auto managedThreadPool = Pothos::ManagedClass()
+    .registerConstructor<Pothos::ThreadPool>()
+    .registerConstructor<Pothos::ThreadPool, const Pothos::ThreadPoolArgs &>()
+    .registerStaticMethod(POTHOS_FCN_TUPLE(Pothos::ThreadPool, getDefault))
+    .registerMethod(POTHOS_FCN_TUPLE(Pothos::ThreadPool, null))
+    .registerMethod(POTHOS_FCN_TUPLE(Pothos::ThreadPool, getArgs))
+    .registerMethod(POTHOS_FCN_TUPLE(Pothos::ThreadPool, getNodeAffinity))
+    .commit("Pothos/ThreadPool");
+
+#include <Pothos/Object/Serialize.hpp>
+
+namespace Pothos { namespace serialization {
+template <class Archive>
+void serialize(Archive &ar, Pothos::ThreadPoolArgs &t, const unsigned int)
+{
+    ar & t.numThreads;
+    ar & t.threadPerBlock;
+    ar & t.workStealing;
+    ar & t.yieldMode;
+    ar & t.backoffSpinCount;
+    ar & t.backoffYieldCount;
+    ar & t.backoffSleepMs;
+    ar & t.priority;
+    ar & t.affinityMode;
+    ar & t.affinity;
+}
+}}
+
+POTHOS_OBJECT_SERIALIZE(Pothos::ThreadPoolArgs)
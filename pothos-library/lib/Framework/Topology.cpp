@@ -171,12 +171,9 @@ static std::vector<Flow> squashFlows(const std::vector<Flow> &flows)
 /***********************************************************************
  * helpers to create network iogress flows
  **********************************************************************/
-std::vector<Flow> Pothos::Topology::Impl::createNetworkFlows()
+std::vector<Flow> Pothos::Topology::Impl::createNetworkFlows(const std::vector<Flow> &flatFlows)
 {
-    //first flatten the topology
-    const auto flatFlows = squashFlows(this->flows);
-
-    //then create network iogress blocks when needed
+    //create network iogress blocks when needed
     std::vector<Flow> networkAwareFlows;
     for (const auto &flow : flatFlows)
     {
@@ -238,6 +235,136 @@ std::vector<Flow> Pothos::Topology::Impl::createNetworkFlows()
     return networkAwareFlows;
 }
 
+/***********************************************************************
+ * helpers to place replicated blocks between a splitter and a merger
+ **********************************************************************/
+static void checkReplicaPort(std::string &portName, const std::string &name, const std::string &uid)
+{
+    if (portName.empty()) portName = name;
+    if (portName == name) return;
+    throw Pothos::TopologyConnectError("Pothos::Topology::commit()",
+        "replicated block must have one connected input and output port: " + uid);
+}
+
+std::vector<Flow> Pothos::Topology::Impl::replicateFlows(const std::vector<Flow> &flatFlows)
+{
+    //find the connected ports of the replicated blocks
+    std::map<std::string, std::pair<Port, Port>> uidToPorts;
+    for (const auto &flow : flatFlows)
+    {
+        const auto srcUid = getUid(flow.src.obj);
+        const auto dstUid = getUid(flow.dst.obj);
+        if (this->uidToReplicas.count(srcUid) != 0)
+        {
+            auto &port = uidToPorts[srcUid].second;
+            port.obj = flow.src.obj;
+            checkReplicaPort(port.name, flow.src.name, srcUid);
+        }
+        if (this->uidToReplicas.count(dstUid) != 0)
+        {
+            auto &port = uidToPorts[dstUid].first;
+            port.obj = flow.dst.obj;
+            checkReplicaPort(port.name, flow.dst.name, dstUid);
+        }
+    }
+
+    //forget the splitters and mergers of blocks that left the topology
+    for (auto it = this->uidToReplicaSplitMerge.begin(); it != this->uidToReplicaSplitMerge.end();)
+    {
+        if (uidToPorts.count(it->first) == 0) this->uidToReplicaSplitMerge.erase(it++);
+        else it++;
+    }
+
+    std::vector<Flow> replicatedFlows;
+    for (const auto &pair : uidToPorts)
+    {
+        const auto &uid = pair.first;
+        const auto &inPort = pair.second.first;
+        const auto &outPort = pair.second.second;
+        if (inPort.name.empty() or outPort.name.empty()) throw Pothos::TopologyConnectError(
+            "Pothos::Topology::commit()", "replicated block must have one connected input and output port: " + uid);
+
+        //the block is the first of its replicas
+        std::vector<Pothos::Object> replicas(1, inPort.obj);
+        const auto &extras = this->uidToReplicas.at(uid);
+        replicas.insert(replicas.end(), extras.begin(), extras.end());
+
+        //replicas without an affinity group join the group of the block
+        const auto groupIt = this->uidToAffinityGroup.find(uid);
+        for (const auto &replica : extras)
+        {
+            if (groupIt == this->uidToAffinityGroup.end()) break;
+            this->uidToAffinityGroup.insert(std::make_pair(getUid(replica), groupIt->second));
+        }
+
+        //create the splitter and merger in the block's environment
+        auto &splitMerge = this->uidToReplicaSplitMerge[uid];
+        if (splitMerge.first.null())
+        {
+            auto actorIface = getWorkerActorInterface(inPort.obj);
+            auto inDType = actorIface.callProxy("getPortDType", true, inPort.name);
+            auto outDType = actorIface.callProxy("getPortDType", false, outPort.name);
+            const auto chunkElements = std::max<size_t>(1,
+                Pothos::BufferManagerArgs().bufferSize/inDType.call<size_t>("size"));
+            auto envReg = actorIface.getEnvironment()->findProxy("Pothos/BlockRegistry");
+            splitMerge.first = envReg.callProxy("/blocks/framework/replica_splitter", inDType, replicas.size(), chunkElements);
+            splitMerge.second = envReg.callProxy("/blocks/framework/replica_merger", outDType, replicas.size(), chunkElements);
+        }
+
+        //deal the stream to the replicas and collect it in order
+        for (size_t i = 0; i < replicas.size(); i++)
+        {
+            Flow splitFlow;
+            splitFlow.src.obj = Pothos::Object(splitMerge.first);
+            splitFlow.src.name = std::to_string(i);
+            splitFlow.dst.obj = replicas[i];
+            splitFlow.dst.name = inPort.name;
+            replicatedFlows.push_back(splitFlow);
+
+            Flow mergeFlow;
+            mergeFlow.src.obj = replicas[i];
+            mergeFlow.src.name = outPort.name;
+            mergeFlow.dst.obj = Pothos::Object(splitMerge.second);
+            mergeFlow.dst.name = std::to_string(i);
+            replicatedFlows.push_back(mergeFlow);
+        }
+    }
+
+    //connect the outside flows to the splitters and mergers
+    for (auto flow : flatFlows)
+    {
+        const auto srcIt = this->uidToReplicaSplitMerge.find(getUid(flow.src.obj));
+        if (srcIt != this->uidToReplicaSplitMerge.end())
+        {
+            flow.src.obj = Pothos::Object(srcIt->second.second);
+            flow.src.name = "0";
+        }
+        const auto dstIt = this->uidToReplicaSplitMerge.find(getUid(flow.dst.obj));
+        if (dstIt != this->uidToReplicaSplitMerge.end())
+        {
+            flow.dst.obj = Pothos::Object(dstIt->second.first);
+            flow.dst.name = "0";
+        }
+        replicatedFlows.push_back(flow);
+    }
+
+    return replicatedFlows;
+}
+
+/***********************************************************************
+ * Helpers to size output buffers for downstream reserve requirements
+ **********************************************************************/
+static void negotiateBufferManagers(const std::vector<Flow> &flows)
+{
+    for (const auto &flow : flows)
+    {
+        auto srcActorIface = getWorkerActorInterface(flow.src.obj);
+        auto dstActorIface = getWorkerActorInterface(flow.dst.obj);
+        const auto reserveBytes = dstActorIface.call<size_t>("getInputReserveBytes", flow.dst.name);
+        if (reserveBytes != 0) srcActorIface.call("negotiateBufferManager", flow.src.name, reserveBytes);
+    }
+}
+
 /***********************************************************************
  * Helpers to implement port subscription
  **********************************************************************/
@@ -252,7 +379,13 @@ static void updateFlows(const std::vector<Flow> &flows, const std::string &actio
         auto srcActorIface = getWorkerActorInterface(flow.src.obj);
         auto dstActorIface = getWorkerActorInterface(flow.dst.obj);
 
-        if (action == "SUBINPUT" or action == "UNSUBINPUT")
+        //a subscriber in the same process receives stream data without port messages
+        if (action == "SUBINPUT" and srcActorIface.call<std::string>("upid") == dstActorIface.call<std::string>("upid"))
+        {
+            srcActorIface.call("sendLocalPortSubscriberMessage", action, flow.src.name, flow.dst.name, dstActorIface);
+            resultActorIfaces.push_back(srcActorIface);
+        }
+        else if (action == "SUBINPUT" or action == "UNSUBINPUT")
         {
             srcActorIface.call("sendPortSubscriberMessage", action, flow.src.name, flow.dst.name, dstActorIface.callProxy("getAddress"));
             resultActorIfaces.push_back(srcActorIface);
@@ -289,6 +422,161 @@ static std::map<std::string, Pothos::Proxy> getActorInterfacesInFlowList(const s
     return interfaces;
 }
 
+/***********************************************************************
+ * Helpers to fuse linear chains of blocks
+ **********************************************************************/
+void Pothos::Topology::Impl::fuseChains(const std::vector<Flow> &flows)
+{
+    this->uidToFusedThreadPool.clear();
+    this->fusedFlows.clear();
+    if (not this->fusionEnabled) return;
+
+    //count the flows on either side of each block
+    std::map<std::string, size_t> uidToNumOut, uidToNumIn;
+    for (const auto &flow : flows)
+    {
+        uidToNumOut[getUid(flow.src.obj)]++;
+        uidToNumIn[getUid(flow.dst.obj)]++;
+    }
+
+    //blocks in the active flows and blocks with a user-set pool keep their thread pools
+    const auto activeInterfaces = getActorInterfacesInFlowList(this->activeFlatFlows);
+    const auto isFusible = [&](const std::string &uid, Pothos::Proxy &actorIface)
+    {
+        if (activeInterfaces.count(uid) != 0) return false;
+        const auto it = this->uidToFusionEnabled.find(uid);
+        if (it != this->uidToFusionEnabled.end() and not it->second) return false;
+        return actorIface.call<bool>("hasDefaultThreadPool");
+    };
+    const auto getGroup = [this](const std::string &uid)
+    {
+        const auto it = this->uidToAffinityGroup.find(uid);
+        return (it == this->uidToAffinityGroup.end())? std::string() : it->second;
+    };
+
+    //a link joins a block with one downstream flow to a block with one upstream flow
+    std::map<std::string, Flow> uidToNextLink;
+    std::set<std::string> linkedDsts;
+    for (const auto &flow : flows)
+    {
+        const auto srcUid = getUid(flow.src.obj);
+        const auto dstUid = getUid(flow.dst.obj);
+        if (srcUid == dstUid) continue;
+        if (uidToNumOut[srcUid] != 1 or uidToNumIn[dstUid] != 1) continue;
+        if (getGroup(srcUid) != getGroup(dstUid)) continue;
+        auto srcActorIface = getWorkerActorInterface(flow.src.obj);
+        auto dstActorIface = getWorkerActorInterface(flow.dst.obj);
+        if (not isFusible(srcUid, srcActorIface) or not isFusible(dstUid, dstActorIface)) continue;
+        if (srcActorIface.call<std::string>("upid") != dstActorIface.call<std::string>("upid")) continue;
+        uidToNextLink[srcUid] = flow;
+        linkedDsts.insert(dstUid);
+    }
+
+    //walk each chain from its head, the links of a ring have no head
+    for (const auto &pair : uidToNextLink)
+    {
+        if (linkedDsts.count(pair.first) != 0) continue;
+
+        //the chain executes on one thread, configured by the chain's affinity group
+        const auto argsIt = this->groupToThreadPoolArgs.find(getGroup(pair.first));
+        Pothos::ThreadPoolArgs args;
+        if (argsIt != this->groupToThreadPoolArgs.end()) args = argsIt->second;
+        args.numThreads = 1;
+        args.threadPerBlock = false;
+        auto headActorIface = getWorkerActorInterface(pair.second.src.obj);
+        auto cls = headActorIface.getEnvironment()->findProxy("Pothos/ThreadPool");
+        auto threadPool = cls.callProxy("new", args);
+
+        this->uidToFusedThreadPool[pair.first] = threadPool;
+        for (auto it = uidToNextLink.find(pair.first); it != uidToNextLink.end();
+            it = uidToNextLink.find(getUid(it->second.dst.obj)))
+        {
+            this->fusedFlows.push_back(it->second);
+            this->uidToFusedThreadPool[getUid(it->second.dst.obj)] = threadPool;
+        }
+    }
+}
+
+static void fuseFlows(const std::vector<Flow> &flows)
+{
+    //result list is used to ack all fuse messages
+    std::vector<Pothos::Proxy> resultActorIfaces;
+
+    for (const auto &flow : flows)
+    {
+        auto srcActorIface = getWorkerActorInterface(flow.src.obj);
+        auto dstActorIface = getWorkerActorInterface(flow.dst.obj);
+        srcActorIface.call("sendFusePortSubscriberMessage", flow.src.name, flow.dst.name, dstActorIface);
+        resultActorIfaces.push_back(srcActorIface);
+    }
+
+    //check all fuse message results
+    for (auto actorIface : resultActorIfaces)
+    {
+        const auto &msg = actorIface.call<std::string>("waitStringResult");
+        if (msg.empty()) continue;
+        throw Pothos::TopologyConnectError("Pothos::Exectutor::commit()", msg);
+    }
+}
+
+/***********************************************************************
+ * Helpers to assign thread pools to blocks
+ **********************************************************************/
+void Pothos::Topology::Impl::assignThreadPools(const std::vector<Flow> &flows)
+{
+    //assign to blocks that are not already in the active flows
+    for (auto pair : getActorInterfacesInFlowList(flows, this->activeFlatFlows))
+    {
+        auto &actorIface = pair.second;
+
+        //lookup the affinity group, the empty name is the default group
+        const auto groupIt = this->uidToAffinityGroup.find(pair.first);
+        const auto group = (groupIt == this->uidToAffinityGroup.end())? "" : groupIt->second;
+        const auto argsIt = this->groupToThreadPoolArgs.find(group);
+        if (argsIt == this->groupToThreadPoolArgs.end() and not group.empty())
+        {
+            throw Pothos::TopologyConnectError("Pothos::Topology::commit()",
+                "affinity group not configured: " + group);
+        }
+
+        //the blocks of a fused chain share the chain's thread pool
+        const auto fusedIt = this->uidToFusedThreadPool.find(pair.first);
+        if (fusedIt != this->uidToFusedThreadPool.end())
+        {
+            actorIface.call("setThreadPool", fusedIt->second);
+            continue;
+        }
+        if (argsIt == this->groupToThreadPoolArgs.end()) continue; //keep the block's thread pool
+
+        //one thread pool per group and process, created in the block's environment
+        const auto key = std::make_pair(group, actorIface.call<std::string>("upid"));
+        auto &threadPool = this->groupUpidToThreadPool[key];
+        if (threadPool.null())
+        {
+            auto cls = actorIface.getEnvironment()->findProxy("Pothos/ThreadPool");
+            threadPool = cls.callProxy("new", argsIt->second);
+        }
+        actorIface.call("setThreadPool", threadPool);
+    }
+}
+
+/***********************************************************************
+ * Helpers to assign buffer managers to output ports
+ **********************************************************************/
+void Pothos::Topology::Impl::assignBufferManagers(const std::vector<Flow> &flows)
+{
+    //configure blocks that are not already in the active flows
+    for (auto pair : getActorInterfacesInFlowList(flows, this->activeFlatFlows))
+    {
+        auto &actorIface = pair.second;
+        const auto begin = this->uidPortToBufferManager.lower_bound(std::make_pair(pair.first, std::string()));
+        for (auto it = begin; it != this->uidPortToBufferManager.end() and it->first.first == pair.first; ++it)
+        {
+            actorIface.call("setOutputBufferManager", it->first.second, it->second.first, it->second.second);
+        }
+    }
+}
+
 /***********************************************************************
  * Topology implementation
  **********************************************************************/
@@ -308,7 +596,15 @@ Pothos::Topology::~Topology(void)
 
 void Pothos::Topology::commit(void)
 {
-    const auto flatFlows = _impl->createNetworkFlows();
+    //flatten the topology and place replicated blocks behind splitters
+    const auto squashedFlows = _impl->replicateFlows(squashFlows(_impl->flows));
+
+    //assign thread pools and buffer managers before inspecting the actors
+    _impl->fuseChains(squashedFlows);
+    _impl->assignThreadPools(squashedFlows);
+    _impl->assignBufferManagers(squashedFlows);
+
+    const auto flatFlows = _impl->createNetworkFlows(squashedFlows);
     const auto &activeFlatFlows = _impl->activeFlatFlows;
 
     //new flows are in flat flows but not in current
@@ -325,9 +621,18 @@ void Pothos::Topology::commit(void)
         if (std::find(flatFlows.begin(), flatFlows.end(), flow) == flatFlows.end()) oldFlows.push_back(flow);
     }
 
+    //assign thread pools to newly created network iogress blocks
+    _impl->assignThreadPools(newFlows);
+
+    //switch to circular buffers where consumers need a contiguous reserve
+    negotiateBufferManagers(newFlows);
+
     //add new data acceptors
     updateFlows(newFlows, "SUBINPUT");
 
+    //deliver messages within fused chains by direct calls
+    fuseFlows(_impl->fusedFlows);
+
     //add new data providers
     updateFlows(newFlows, "SUBOUTPUT");
 
@@ -438,6 +743,66 @@ void Pothos::Topology::disconnectAll(void)
     _impl->flows.clear();
 }
 
+void Pothos::Topology::setThreadPoolArgs(const ThreadPoolArgs &args)
+{
+    this->setThreadPoolArgs("", args);
+}
+
+void Pothos::Topology::setThreadPoolArgs(const std::string &group, const ThreadPoolArgs &args)
+{
+    _impl->groupToThreadPoolArgs[group] = args;
+
+    //forget the thread pools of this group so they are recreated
+    for (auto it = _impl->groupUpidToThreadPool.begin(); it != _impl->groupUpidToThreadPool.end();)
+    {
+        if (it->first.first == group) _impl->groupUpidToThreadPool.erase(it++);
+        else it++;
+    }
+}
+
+void Pothos::Topology::_setAffinityGroup(const Object &obj, const std::string &group)
+{
+    const auto uid = getUid(obj);
+    if (uid.empty()) throw Pothos::TopologyConnectError("Pothos::Topology::setAffinityGroup()",
+        "block of type " + obj.toString());
+    _impl->uidToAffinityGroup[uid] = group;
+}
+
+void Pothos::Topology::_setBufferManager(const Object &obj, const std::string &port, const std::string &name, const BufferManagerArgs &args)
+{
+    const auto uid = getUid(obj);
+    if (uid.empty()) throw Pothos::TopologyConnectError("Pothos::Topology::setBufferManager()",
+        "block of type " + obj.toString());
+    _impl->uidPortToBufferManager[std::make_pair(uid, port)] = std::make_pair(name, args);
+}
+
+void Pothos::Topology::setFusionEnabled(const bool enabled)
+{
+    _impl->fusionEnabled = enabled;
+}
+
+void Pothos::Topology::_setFusionEnabled(const Object &obj, const bool enabled)
+{
+    const auto uid = getUid(obj);
+    if (uid.empty()) throw Pothos::TopologyConnectError("Pothos::Topology::setFusionEnabled()",
+        "block of type " + obj.toString());
+    _impl->uidToFusionEnabled[uid] = enabled;
+}
+
+void Pothos::Topology::_addReplica(const Object &obj, const Object &replica)
+{
+    const auto uid = getUid(obj);
+    if (uid.empty()) throw Pothos::TopologyConnectError("Pothos::Topology::addReplica()",
+        "block of type " + obj.toString());
+    const auto replicaUid = getUid(replica);
+    if (replicaUid.empty() or replicaUid == uid) throw Pothos::TopologyConnectError("Pothos::Topology::addReplica()",
+        "replica of type " + replica.toString());
+    _impl->uidToReplicas[uid].push_back(replica);
+
+    //the splitter and merger are recreated with a port for the new replica
+    _impl->uidToReplicaSplitMerge.erase(uid);
+}
+
 bool Pothos::Topology::waitInactive(const double idleDuration, const double timeout)
 {
     //how long to sleep between idle checks?
@@ -450,10 +815,14 @@ bool Pothos::Topology::waitInactive(const double idleDuration, const double time
     const Poco::Timestamp exitTime = Poco::Timestamp() + Poco::Timespan(Poco::Timespan::TimeDiff(timeout*1e6));
     do
     {
+        //request the stats from every worker before waiting on the replies
+        for (auto pair : interfaces) pair.second.call("sendStatsRequest");
+        std::vector<WorkerStats> allStats;
+        for (auto pair : interfaces) allStats.push_back(pair.second.call<WorkerStats>("waitStatsResult"));
+
         //check each worker for idle time from the stats
-        for (auto pair : interfaces)
+        for (const auto &stats : allStats)
         {
-            const auto stats = pair.second.call<WorkerStats>("getWorkerStats");
             const auto consumptionIdle = stats.ticksStatsQuery - stats.ticksLastConsumed;
             const auto productionIdle = stats.ticksStatsQuery - stats.ticksLastProduced;
             const auto workerIdleDuration = std::min(consumptionIdle, productionIdle);
@@ -470,3 +839,84 @@ bool Pothos::Topology::waitInactive(const double idleDuration, const double time
 
     return false; //timeout
 }
+
+bool Pothos::Topology::waitDone(const double timeout)
+{
+    const auto interfaces = getActorInterfacesInFlowList(_impl->activeFlatFlows);
+
+    //each worker signals an event once it is done, so there is no polling
+    const Poco::Timestamp exitTime = Poco::Timestamp() + Poco::Timespan(Poco::Timespan::TimeDiff(timeout*1e6));
+    for (auto pair : interfaces)
+    {
+        const long timeoutMs = long(std::max<Poco::Timestamp::TimeDiff>(exitTime - Poco::Timestamp(), 0)/1000);
+        if (not pair.second.call<bool>("waitDone", timeoutMs)) return false;
+    }
+    return true;
+}
+
+Pothos::TopologyStats Pothos::Topology::queryStats(void)
+{
+    const auto &flows = _impl->activeFlatFlows;
+    const auto interfaces = getActorInterfacesInFlowList(flows);
+
+    //request the stats from every worker before waiting on the replies
+    for (auto pair : interfaces) pair.second.call("sendStatsRequest");
+    std::map<std::string, WorkerStats> uidToStats;
+    for (auto pair : interfaces) uidToStats[pair.first] = pair.second.call<WorkerStats>("waitStatsResult");
+
+    //the cpu share is relative to the work time of all blocks
+    const auto workTicks = [](const WorkerStats &stats)
+    {
+        return stats.totalTicksWork + stats.totalTicksPreWork + stats.totalTicksPostWork;
+    };
+    double totalWorkTime = 0.0;
+    for (const auto &pair : uidToStats) totalWorkTime += double(workTicks(pair.second))/pair.second.tickRate;
+
+    TopologyStats result;
+    for (const auto &pair : uidToStats)
+    {
+        const auto &stats = pair.second;
+        BlockStats block;
+        block.uid = pair.first;
+        if (stats.ticksActivated != 0) block.elapsedTime = double(stats.ticksStatsQuery - stats.ticksActivated)/stats.tickRate;
+        block.workTime = double(workTicks(stats))/stats.tickRate;
+        if (totalWorkTime > 0.0) block.cpuShare = block.workTime/totalWorkTime;
+        block.numWorkCalls = stats.numWorkCalls;
+        block.workHistogram = stats.workHistogram;
+        result.blocks.push_back(block);
+    }
+
+    for (const auto &flow : flows)
+    {
+        EdgeStats edge;
+        edge.srcUid = getUid(flow.src.obj);
+        edge.srcPort = flow.src.name;
+        edge.dstUid = getUid(flow.dst.obj);
+        edge.dstPort = flow.dst.name;
+
+        const auto &srcStats = uidToStats.at(edge.srcUid);
+        const auto srcIt = srcStats.outputStats.find(edge.srcPort);
+        if (srcIt != srcStats.outputStats.end())
+        {
+            edge.totalElements = srcIt->second.totalElements;
+            edge.totalMessages = srcIt->second.totalMessages;
+            edge.totalLabels = srcIt->second.totalLabels;
+            edge.srcBlockedTime = double(srcIt->second.totalTicksBlocked)/srcStats.tickRate;
+            const auto elapsedTicks = srcStats.ticksStatsQuery - srcStats.ticksActivated;
+            if (srcStats.ticksActivated != 0 and elapsedTicks != 0) edge.elementRate = edge.totalElements/(double(elapsedTicks)/srcStats.tickRate);
+        }
+
+        const auto &dstStats = uidToStats.at(edge.dstUid);
+        const auto dstIt = dstStats.inputStats.find(edge.dstPort);
+        if (dstIt != dstStats.inputStats.end())
+        {
+            edge.queuedElements = dstIt->second.queuedElements;
+            edge.queuedMessages = dstIt->second.queuedMessages;
+            edge.queuedLabels = dstIt->second.queuedLabels;
+            edge.dstBlockedTime = double(dstIt->second.totalTicksBlocked)/dstStats.tickRate;
+        }
+        result.edges.push_back(edge);
+    }
+
+    return result;
+}
@@ -3,7 +3,10 @@
 
 #pragma once
 #include <Pothos/Framework/Topology.hpp>
+#include <Pothos/Proxy/Proxy.hpp>
 #include <unordered_map>
+#include <map>
+#include <utility> //pair
 #include <vector>
 #include <functional> //std::hash
 
@@ -78,8 +81,28 @@ namespace std
  **********************************************************************/
 struct Pothos::Topology::Impl
 {
+    Impl(void):
+        fusionEnabled(false)
+    {
+        return;
+    }
+
     std::vector<Flow> flows;
     std::vector<Flow> activeFlatFlows;
     std::unordered_map<Flow, std::pair<Flow, Flow>> flowToNetgressCache;
-    std::vector<Flow> createNetworkFlows(void);
+    std::vector<Flow> createNetworkFlows(const std::vector<Flow> &flatFlows);
+    std::map<std::string, Pothos::ThreadPoolArgs> groupToThreadPoolArgs;
+    std::map<std::string, std::string> uidToAffinityGroup;
+    std::map<std::pair<std::string, std::string>, Pothos::Proxy> groupUpidToThreadPool;
+    std::map<std::pair<std::string, std::string>, std::pair<std::string, Pothos::BufferManagerArgs>> uidPortToBufferManager;
+    bool fusionEnabled;
+    std::map<std::string, bool> uidToFusionEnabled;
+    std::map<std::string, Pothos::Proxy> uidToFusedThreadPool;
+    std::vector<Flow> fusedFlows;
+    void fuseChains(const std::vector<Flow> &flows);
+    std::map<std::string, std::vector<Pothos::Object>> uidToReplicas;
+    std::map<std::string, std::pair<Pothos::Proxy, Pothos::Proxy>> uidToReplicaSplitMerge;
+    std::vector<Flow> replicateFlows(const std::vector<Flow> &flows);
+    void assignThreadPools(const std::vector<Flow> &flows);
+    void assignBufferManagers(const std::vector<Flow> &flows);
 };
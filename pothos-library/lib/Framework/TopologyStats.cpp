@@ -0,0 +1,100 @@
+// Copyright (c) 2014-2014 Josh Blum
+// SPDX-License-Identifier: BSL-1.0
+
+#include <Pothos/Framework/TopologyStats.hpp>
+#include <Poco/JSON/Object.h>
+#include <Poco/JSON/Array.h>
+#include <Poco/Format.h>
+#include <sstream>
+
+Pothos::BlockStats::BlockStats(void):
+    elapsedTime(0.0),
+    workTime(0.0),
+    cpuShare(0.0),
+    numWorkCalls(0)
+{
+    return;
+}
+
+Pothos::EdgeStats::EdgeStats(void):
+    totalElements(0),
+    totalMessages(0),
+    totalLabels(0),
+    elementRate(0.0),
+    queuedElements(0),
+    queuedMessages(0),
+    queuedLabels(0),
+    srcBlockedTime(0.0),
+    dstBlockedTime(0.0)
+{
+    return;
+}
+
+std::string Pothos::TopologyStats::toJSON(void) const
+{
+    Poco::JSON::Array blocksArray;
+    for (const auto &block : this->blocks)
+    {
+        Poco::JSON::Array histogram;
+        for (const auto count : block.workHistogram) histogram.add(Poco::UInt64(count));
+        Poco::JSON::Object obj;
+        obj.set("uid", block.uid);
+        obj.set("elapsedTime", block.elapsedTime);
+        obj.set("workTime", block.workTime);
+        obj.set("cpuShare", block.cpuShare);
+        obj.set("numWorkCalls", Poco::UInt64(block.numWorkCalls));
+        obj.set("workHistogram", histogram);
+        blocksArray.add(obj);
+    }
+
+    Poco::JSON::Array edgesArray;
+    for (const auto &edge : this->edges)
+    {
+        Poco::JSON::Object obj;
+        obj.set("srcUid", edge.srcUid);
+        obj.set("srcPort", edge.srcPort);
+        obj.set("dstUid", edge.dstUid);
+        obj.set("dstPort", edge.dstPort);
+        obj.set("totalElements", Poco::UInt64(edge.totalElements));
+        obj.set("totalMessages", Poco::UInt64(edge.totalMessages));
+        obj.set("totalLabels", Poco::UInt64(edge.totalLabels));
+        obj.set("elementRate", edge.elementRate);
+        obj.set("queuedElements", Poco::UInt64(edge.queuedElements));
+        obj.set("queuedMessages", Poco::UInt64(edge.queuedMessages));
+        obj.set("queuedLabels", Poco::UInt64(edge.queuedLabels));
+        obj.set("srcBlockedTime", edge.srcBlockedTime);
+        obj.set("dstBlockedTime", edge.dstBlockedTime);
+        edgesArray.add(obj);
+    }
+
+    Poco::JSON::Object topObj;
+    topObj.set("blocks", blocksArray);
+    topObj.set("edges", edgesArray);
+    std::stringstream ss;
+    topObj.stringify(ss, 4);
+    return ss.str();
+}
+
+std::string Pothos::TopologyStats::toDotMarkup(void) const
+{
+    std::stringstream ss;
+    ss << "digraph topology {" << std::endl;
+    ss << "    node [shape=box];" << std::endl;
+    for (const auto &block : this->blocks)
+    {
+        ss << "    \"" << block.uid << "\" [label=\"" << block.uid
+           << Poco::format("\\ncpu %0.1f%%", block.cpuShare*100)
+           << "\\n" << block.numWorkCalls << " work calls\"];" << std::endl;
+    }
+    for (const auto &edge : this->edges)
+    {
+        ss << "    \"" << edge.srcUid << "\" -> \"" << edge.dstUid << "\" ["
+           << "taillabel=\"" << edge.srcPort << "\", headlabel=\"" << edge.dstPort << "\", label=\""
+           << Poco::format("%0.3f Melements/s", edge.elementRate/1e6)
+           << "\\nqueued " << edge.queuedElements
+           << Poco::format("\\nblocked %0.3fs / %0.3fs", edge.srcBlockedTime, edge.dstBlockedTime)
+           << "\"];" << std::endl;
+    }
+    ss << "}" << std::endl;
+    return ss.str();
+}
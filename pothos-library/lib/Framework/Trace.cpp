@@ -0,0 +1,210 @@
+// Copyright (c) 2014-2014 Josh Blum
+// SPDX-License-Identifier: BSL-1.0
+
+#include "Framework/WorkerTrace.hpp"
+#include <Pothos/Framework/Trace.hpp>
+#include <Pothos/Exception.hpp>
+#include <Poco/Process.h>
+#include <Poco/Format.h>
+#include <algorithm> //min
+#include <fstream>
+#include <sstream>
+#include <memory>
+#include <vector>
+#include <mutex>
+#include <set>
+
+std::atomic<bool> traceEnabledFlag(false);
+
+/***********************************************************************
+ * Per-thread ring of trace events:
+ * Only the owner thread writes, and it publishes the head after
+ * each event, so a reader sees the events before the head.
+ * A ring is never freed, the events outlive the thread;
+ * when the thread exits, the next new thread reuses its ring.
+ **********************************************************************/
+static const size_t TRACE_RING_SIZE = 1 << 16; //events per thread
+
+struct TraceEvent
+{
+    const char *name;
+    const char *block;
+    unsigned long long start;
+    unsigned long long end; //zero for instant events
+};
+
+struct TraceRing
+{
+    TraceRing(const size_t tid):
+        tid(tid),
+        head(0),
+        events(TRACE_RING_SIZE)
+    {
+        return;
+    }
+
+    inline void push(const TraceEvent &event)
+    {
+        const auto h = head.load(std::memory_order_relaxed);
+        events[h % TRACE_RING_SIZE] = event;
+        head.store(h+1, std::memory_order_release);
+    }
+
+    const size_t tid;
+    std::atomic<unsigned long long> head;
+    std::vector<TraceEvent> events;
+};
+
+struct TraceRegistry
+{
+    TraceRegistry(void):
+        ticksCleared(0)
+    {
+        return;
+    }
+
+    std::mutex mutex;
+    std::vector<TraceRing *> rings;
+    std::vector<TraceRing *> freeRings; //released by exited threads
+    std::set<std::string> names;
+    std::atomic<unsigned long long> ticksCleared;
+};
+
+static TraceRegistry &getTraceRegistry(void)
+{
+    //never destroyed: threads may trace during static destruction
+    static TraceRegistry *registry = new TraceRegistry();
+    return *registry;
+}
+
+//holds the ring of a thread, and releases it when the thread exits
+struct TraceThreadOwner
+{
+    TraceThreadOwner(void):
+        ring(nullptr)
+    {
+        return;
+    }
+
+    ~TraceThreadOwner(void)
+    {
+        if (ring == nullptr) return;
+        auto &registry = getTraceRegistry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        registry.freeRings.push_back(ring);
+    }
+
+    TraceRing *ring;
+};
+
+static thread_local TraceThreadOwner traceThreadOwner;
+
+static TraceRing &getTraceThreadRing(void)
+{
+    auto &owner = traceThreadOwner;
+    if (owner.ring == nullptr)
+    {
+        auto &registry = getTraceRegistry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        if (registry.freeRings.empty())
+        {
+            owner.ring = new TraceRing(registry.rings.size());
+            registry.rings.push_back(owner.ring);
+        }
+        else
+        {
+            owner.ring = registry.freeRings.back();
+            registry.freeRings.pop_back();
+        }
+    }
+    return *owner.ring;
+}
+
+/***********************************************************************
+ * Recording hooks for the workers
+ **********************************************************************/
+const char *internTraceName(const std::string &name)
+{
+    auto &registry = getTraceRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    return registry.names.insert(name).first->c_str();
+}
+
+void recordTraceSpan(const char *name, const char *block, const unsigned long long start, const unsigned long long end)
+{
+    TraceEvent event;
+    event.name = name;
+    event.block = block;
+    event.start = start;
+    event.end = end;
+    getTraceThreadRing().push(event);
+}
+
+void recordTraceInstant(const char *name, const char *block)
+{
+    recordTraceSpan(name, block, Theron::Detail::Clock::GetTicks(), 0);
+}
+
+/***********************************************************************
+ * Public tracing API
+ **********************************************************************/
+void Pothos::Trace::setEnabled(const bool enabled)
+{
+    traceEnabledFlag.store(enabled);
+}
+
+bool Pothos::Trace::isEnabled(void)
+{
+    return traceEnabledFlag.load();
+}
+
+void Pothos::Trace::clear(void)
+{
+    //events are filtered by time, the writers are never interrupted
+    getTraceRegistry().ticksCleared.store(Theron::Detail::Clock::GetTicks());
+}
+
+std::string Pothos::Trace::toJSON(void)
+{
+    auto &registry = getTraceRegistry();
+    std::vector<TraceRing *> rings;
+    {
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        rings = registry.rings;
+    }
+    const auto ticksCleared = registry.ticksCleared.load();
+    const double usPerTick = 1e6/Theron::Detail::Clock::GetFrequency();
+    const int pid = int(Poco::Process::id());
+
+    std::stringstream ss;
+    ss << "{\"displayTimeUnit\": \"ns\", \"traceEvents\": [";
+    bool first = true;
+    for (const auto ring : rings)
+    {
+        const auto head = ring->head.load(std::memory_order_acquire);
+        const auto num = std::min<unsigned long long>(head, TRACE_RING_SIZE);
+        for (auto i = head-num; i < head; i++)
+        {
+            const auto &event = ring->events[i % TRACE_RING_SIZE];
+            if (event.start < ticksCleared) continue;
+            if (not first) ss << ",";
+            first = false;
+            ss << "\n{\"name\": \"" << event.name << "\", \"cat\": \"worker\"";
+            ss << ", \"pid\": " << pid << ", \"tid\": " << ring->tid;
+            ss << Poco::format(", \"ts\": %0.3f", event.start*usPerTick);
+            if (event.end == 0) ss << ", \"ph\": \"i\", \"s\": \"t\"";
+            else ss << Poco::format(", \"ph\": \"X\", \"dur\": %0.3f", (event.end-event.start)*usPerTick);
+            ss << ", \"args\": {\"block\": \"" << event.block << "\"}}";
+        }
+    }
+    ss << "\n]}\n";
+    return ss.str();
+}
+
+void Pothos::Trace::writeFile(const std::string &path)
+{
+    std::ofstream file(path.c_str());
+    if (not file) throw Pothos::FileException("Pothos::Trace::writeFile()", "cannot open " + path);
+    file << Pothos::Trace::toJSON();
+    if (not file) throw Pothos::FileException("Pothos::Trace::writeFile()", "cannot write " + path);
+}
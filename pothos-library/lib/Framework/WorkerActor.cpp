@@ -8,24 +8,98 @@
 /***********************************************************************
  * pre-work
  **********************************************************************/
+
+/*!
+ * Can an output write over this input buffer?
+ * The accumulator must hold the only reference,
+ * and the chunk must lie within its own allocation,
+ * since merged chunks can span memory held by other chunks.
+ * Circular buffers are excluded for the same reason.
+ */
+static bool isInPlaceCapable(const Pothos::BufferChunk &buffer)
+{
+    if (buffer.length == 0 or not buffer.unique()) return false;
+    const auto &shared = buffer.getBuffer();
+    return shared.getAlias() == 0 and buffer.getEnd() <= shared.getEnd();
+}
+
 bool Pothos::WorkerActor::preWorkTasks(void)
 {
     const size_t BIG = (1 << 30);
 
+    //collect the stream data delivered from other threads
+    this->flushStreamDeliveries();
+
     bool allOutputsReady = true;
     bool allInputsReady = true;
     bool hasInputMessage = false;
+    bool hasConnectedInput = false;
+    bool allInputsEnded = true;
+    bool flushAtEnd = true;
+    unsigned long long now = 0; //read on demand by the blocked time tracking
+
+    //////////////// input state calculation ///////////////////
+    workInfo.minInElements = BIG;
+    workInfo.minAllInElements = BIG;
+    for (auto &entry : this->flatInputs)
+    {
+        auto &port = *entry.port;
+        const size_t reserveBytes = port._reserveElements*entry.elemSize;
+        entry.impl->bufferAccumulator.require(reserveBytes);
+        const auto &front = entry.impl->bufferAccumulator.front();
+        if (entry.impl->readBeforeWrite)
+        {
+            //drop the port's reference so only the accumulator holds the front
+            port._buffer = BufferChunk();
+            entry.impl->bufferInPlace = isInPlaceCapable(front);
+        }
+        port._buffer = front;
+        port._elements = port._buffer.length/entry.elemSize;
+        if (port._elements < port._reserveElements)
+        {
+            allInputsReady = false;
+            if (not port._flushAtEnd) flushAtEnd = false;
+        }
+        if (not entry.impl->asyncMessages.empty()) hasInputMessage = true;
+        if (not entry.impl->subscribers.empty())
+        {
+            hasConnectedInput = true;
+            if (not port.isEndOfStream()) allInputsEnded = false;
+        }
+        entry.impl->stats.updateBlocked(entry.impl->asyncMessages.empty() and
+            (port._elements == 0 or port._elements < port._reserveElements), now);
+        port._pendingElements = 0;
+        port._labelIter = entry.impl->inlineMessages.range();
+        if (port.index() != -1)
+        {
+            assert(workInfo.inputPointers.size() > size_t(port.index()));
+            workInfo.inputPointers[port.index()] = port._buffer.as<const void *>();
+            workInfo.minInElements = std::min(workInfo.minInElements, port._elements);
+        }
+        workInfo.minAllInElements = std::min(workInfo.minAllInElements, port._elements);
+    }
 
     //////////////// output state calculation ///////////////////
     workInfo.minOutElements = BIG;
     workInfo.minAllOutElements = BIG;
-    for (auto &entry : this->outputs)
+    for (auto &entry : this->flatOutputs)
     {
-        auto &port = *entry.second;
-        if (port._impl->bufferManager->empty()) port._buffer = BufferChunk();
-        else port._buffer = port._impl->bufferManager->front();
-        port._elements = port._buffer.length/port.dtype().size();
+        auto &port = *entry.port;
+        entry.mgr->flushExternal(); //collect buffers returned from other threads
+
+        //write over a uniquely held input buffer, at most one output per input
+        auto input = entry.impl->readBeforeWrite;
+        entry.impl->bufferFromInput = input != nullptr and input->_impl->bufferInPlace;
+        if (entry.impl->bufferFromInput)
+        {
+            input->_impl->bufferInPlace = false;
+            port._buffer = input->_buffer;
+        }
+        else if (entry.mgr->empty()) port._buffer = BufferChunk();
+        else port._buffer = entry.mgr->front();
+        port._elements = port._buffer.length/entry.elemSize;
         if (port._elements == 0) allOutputsReady = false;
+        entry.impl->stats.updateBlocked(port._elements == 0 or not throttlingConsumers.empty(), now);
         port._pendingElements = 0;
         if (port.index() != -1)
         {
@@ -36,29 +110,6 @@ bool Pothos::WorkerActor::preWorkTasks(void)
         workInfo.minAllOutElements = std::min(workInfo.minAllOutElements, port._elements);
     }
 
-    //////////////// input state calculation ///////////////////
-    workInfo.minInElements = BIG;
-    workInfo.minAllInElements = BIG;
-    for (auto &entry : this->inputs)
-    {
-        auto &port = *entry.second;
-        const size_t reserveBytes = port._reserveElements*port.dtype().size();
-        port._impl->bufferAccumulator.require(reserveBytes);
-        port._buffer = port._impl->bufferAccumulator.front();
-        port._elements = port._buffer.length/port.dtype().size();
-        if (port._elements < port._reserveElements) allInputsReady = false;
-        if (not port._impl->asyncMessages.empty()) hasInputMessage = true;
-        port._pendingElements = 0;
-        port._labelIter = port._impl->inlineMessages;
-        if (port.index() != -1)
-        {
-            assert(workInfo.inputPointers.size() > size_t(port.index()));
-            workInfo.inputPointers[port.index()] = port._buffer.as<const void *>();
-            workInfo.minInElements = std::min(workInfo.minInElements, port._elements);
-        }
-        workInfo.minAllInElements = std::min(workInfo.minAllInElements, port._elements);
-    }
-
     //calculate overall minimums
     workInfo.minElements = std::min(workInfo.minInElements, workInfo.minOutElements);
     workInfo.minAllElements = std::min(workInfo.minAllInElements, workInfo.minAllOutElements);
@@ -66,7 +117,19 @@ bool Pothos::WorkerActor::preWorkTasks(void)
     //arbitrary time, but its small
     workInfo.maxTimeoutNs = 1000000; //1 millisecond
 
-    return allOutputsReady and (allInputsReady or hasInputMessage);
+    //a consumer with a full message queue throttles this block
+    if (not throttlingConsumers.empty()) return false;
+
+    //ended inputs call work() below the reserve only for ports that opted in,
+    //otherwise the remainder is dropped and the block is done without work()
+    const bool inputsEnded = hasConnectedInput and allInputsEnded;
+    if (inputsEnded and not allInputsReady and not hasInputMessage and not flushAtEnd)
+    {
+        this->updateEndOfStream(true);
+        return false;
+    }
+
+    return allOutputsReady and (allInputsReady or hasInputMessage or inputsEnded);
 }
 
 /***********************************************************************
@@ -74,31 +137,60 @@ bool Pothos::WorkerActor::preWorkTasks(void)
  **********************************************************************/
 void Pothos::WorkerActor::postWorkTasks(void)
 {
+    const auto now = Theron::Detail::Clock::GetTicks();
+
+    ///////////////////// output totals ////////////////////////
+    //Note: propagateLabels() sees the totals including this work() call
+
+    for (auto &entry : this->flatOutputs)
+    {
+        auto &port = *entry.port;
+        port._totalElements += port._pendingElements;
+        for (size_t i = 0; i < entry.impl->postedBuffers.size(); i++)
+        {
+            port._totalElements += entry.impl->postedBuffers[i].length/entry.elemSize;
+        }
+    }
+
     ///////////////////// input handling ////////////////////////
 
     unsigned long long bytesConsumed = 0;
     unsigned long long msgsConsumed = 0;
 
-    for (auto &entry : this->inputs)
+    for (auto &entry : this->flatInputs)
     {
-        auto &port = *entry.second;
-        const size_t bytes = port._pendingElements*port.dtype().size();
+        auto &port = *entry.port;
+        const size_t bytes = port._pendingElements*entry.elemSize;
         bytesConsumed += bytes;
         msgsConsumed += port._totalMessages;
 
+        //resume the throttled producers once the messages drain to half
+        if (not entry.impl->throttledProducers.empty() and
+            entry.impl->asyncMessages.size() <= entry.impl->messageDepth/2)
+        {
+            this->releaseProducers(*entry.impl);
+        }
+
         //set the buffer length, send it, pop from manager, clear reference
         if (bytes != 0)
         {
             port._buffer = BufferChunk(); //clear reference
-            port._impl->bufferAccumulator.pop(bytes);
+            entry.impl->bufferAccumulator.pop(bytes);
         }
 
         //move consumed elements into total
         port._totalElements += port._pendingElements;
 
+        //update the port stats
+        auto &stats = entry.impl->stats;
+        if (bytes != 0) stats.ticksLastBuffer = now;
+        if (stats.totalMessages != port._totalMessages) stats.ticksLastMessage = now;
+        stats.totalElements = port._totalElements;
+        stats.totalMessages = port._totalMessages;
+
         //propagate labels and delete old
         size_t numLabels = 0;
-        auto &allLabels = port._impl->inlineMessages;
+        auto &allLabels = entry.impl->inlineMessages;
         for (size_t i = 0; i < allLabels.size(); i++)
         {
             if (allLabels[i].index < port.totalElements()) numLabels++;
@@ -106,7 +198,7 @@ void Pothos::WorkerActor::postWorkTasks(void)
         }
         if (numLabels != 0)
         {
-            LabelIteratorRange iter(allLabels.begin(), allLabels.begin()+numLabels);
+            const auto iter = allLabels.range(numLabels);
             try
             {
                 block->propagateLabels(&port, iter);
@@ -127,14 +219,16 @@ void Pothos::WorkerActor::postWorkTasks(void)
                 poco_error_f1(Poco::Logger::get("Pothos.WorkerActor.propagateLabels"),
                     "Block TODO threw in overloaded call to propagateLabels() - %s", std::string("unknown"));
             }
-            allLabels.erase(allLabels.begin(), allLabels.begin()+numLabels);
+            allLabels.pop(numLabels);
+            stats.totalLabels += numLabels;
+            stats.ticksLastLabel = now;
         }
     }
 
     //update consumption stats, bytes are incremental, messages cumulative
     if (bytesConsumed != 0 or this->workStats.msgsConsumed != msgsConsumed)
     {
-        this->workStats.ticksLastConsumed = Theron::Detail::Clock::GetTicks();
+        this->workStats.ticksLastConsumed = now;
     }
     this->workStats.bytesConsumed += bytesConsumed;
     this->workStats.msgsConsumed = msgsConsumed;
@@ -145,10 +239,10 @@ void Pothos::WorkerActor::postWorkTasks(void)
     unsigned long long bytesProduced = 0;
     unsigned long long msgsProduced = 0;
 
-    for (auto &entry : this->outputs)
+    for (auto &entry : this->flatOutputs)
     {
-        auto &port = *entry.second;
-        const size_t bytes = port._pendingElements*port.dtype().size();
+        auto &port = *entry.port;
+        const size_t bytes = port._pendingElements*entry.elemSize;
         bytesProduced += bytes;
         msgsProduced += port._totalMessages;
 
@@ -158,28 +252,40 @@ void Pothos::WorkerActor::postWorkTasks(void)
             auto buffer = port._buffer;
             port._buffer = BufferChunk(); //clear reference
             buffer.length = bytes;
-            port._impl->bufferManager->pop(buffer.length);
-            this->sendPortMessage(port._impl->subscribers, buffer);
+            if (not entry.impl->bufferFromInput) entry.mgr->pop(buffer.length);
+            this->sendStreamBuffer(*entry.impl, buffer);
         }
 
+        //release the borrowed input buffer so it can be unique next time
+        if (entry.impl->bufferFromInput) port._buffer = BufferChunk();
+
         //send the external buffers in the queue
-        while (not port._impl->postedBuffers.empty())
+        while (not entry.impl->postedBuffers.empty())
         {
-            auto &buffer = port._impl->postedBuffers.front();
+            auto &buffer = entry.impl->postedBuffers.front();
             bytesProduced += buffer.length;
-            port._totalElements += buffer.length/port.dtype().size();
-            this->sendPortMessage(port._impl->subscribers, buffer);
-            port._impl->postedBuffers.pop_front();
+            this->sendStreamBuffer(*entry.impl, buffer);
+            entry.impl->postedBuffers.pop_front();
         }
 
-        //move produced elements into total
-        port._totalElements += port._pendingElements;
+        //send the labels that were posted without a buffer
+        if (not entry.impl->postedLabels.empty()) this->sendStreamBuffer(*entry.impl, BufferChunk());
+
+        //end-of-stream follows the last buffer of this port
+        if (entry.impl->endOfStream) this->sendEndOfStream(*entry.impl);
+
+        //update the port stats, the totals include the posted buffers
+        auto &stats = entry.impl->stats;
+        if (stats.totalElements != port._totalElements) stats.ticksLastBuffer = now;
+        if (stats.totalMessages != port._totalMessages) stats.ticksLastMessage = now;
+        stats.totalElements = port._totalElements;
+        stats.totalMessages = port._totalMessages;
     }
 
     //update production stats, bytes are incremental, messages cumulative
     if (bytesProduced != 0 or this->workStats.msgsProduced != msgsProduced)
     {
-        this->workStats.ticksLastProduced = Theron::Detail::Clock::GetTicks();
+        this->workStats.ticksLastProduced = now;
     }
     this->workStats.bytesProduced += bytesProduced;
     this->workStats.msgsProduced = msgsProduced;
@@ -191,3 +297,138 @@ void Pothos::WorkerActor::postWorkTasks(void)
     //if (this->inputs.size() == 0)
     this->bump();
 }
+
+/***********************************************************************
+ * end of stream
+ **********************************************************************/
+void Pothos::WorkerActor::sendEndOfStream(OutputPortImpl &impl)
+{
+    if (impl.endOfStreamSent or not active) return;
+    impl.endOfStreamSent = true;
+    this->sendPortMessage(impl.subscribers, EndOfStream());
+}
+
+void Pothos::WorkerActor::updateEndOfStream(const bool idleAtEnd)
+{
+    if (done or not active) return;
+
+    //every connected input ended, and work() had its chance to flush
+    bool hasInputs = false;
+    for (const auto &entry : this->flatInputs)
+    {
+        if (entry.impl->subscribers.empty()) continue;
+        hasInputs = true;
+        if (not entry.port->isEndOfStream()) return;
+    }
+    if (hasInputs and not idleAtEnd) return;
+
+    //the ended inputs end all outputs, a source must end them itself
+    bool hasOutputs = false;
+    for (auto &entry : this->flatOutputs)
+    {
+        if (entry.impl->subscribers.empty()) continue;
+        hasOutputs = true;
+        if (hasInputs) entry.impl->endOfStream = true;
+        if (not entry.impl->endOfStream) return;
+        this->sendEndOfStream(*entry.impl);
+    }
+
+    //a block without connections is not part of a stream
+    if (not hasInputs and not hasOutputs) return;
+
+    done = true;
+    doneEvent.set();
+}
+
+/***********************************************************************
+ * in-process stream delivery
+ **********************************************************************/
+bool Pothos::WorkerActor::postStreamDelivery(const PortSubscriber &s, StreamDelivery &delivery) const
+{
+    delivery.index = s.index;
+    if (s.index == -1) delivery.name = s.name;
+
+    auto &subWakeup = *s.localActor->wakeup;
+    {
+        std::lock_guard<std::mutex> lock(subWakeup.mutex);
+        subWakeup.deliveries.push_back(std::move(delivery));
+    }
+
+    //schedule the subscriber once until its bump handler runs
+    if (not subWakeup.scheduled.exchange(true))
+    {
+        this->GetFramework().Send(BumpWorkMessage(), this->GetAddress(), s.address);
+    }
+    return true;
+}
+
+void Pothos::WorkerActor::flushStreamDeliveries(void)
+{
+    {
+        std::lock_guard<std::mutex> lock(wakeup->mutex);
+        if (wakeup->deliveries.empty()) return;
+        flushedDeliveries.swap(wakeup->deliveries);
+    }
+
+    for (auto &delivery : flushedDeliveries)
+    {
+        auto &input = (delivery.index != -1)?
+            getInput(size_t(delivery.index), __FUNCTION__):
+            getInput(delivery.name, __FUNCTION__);
+        traceInstant(traceName, (delivery.contents.buffer.length == 0)? "recvLabel" : "recvBuffer");
+        for (const auto &label : delivery.contents.labels) input._impl->inlineMessages.push(label);
+        if (delivery.contents.buffer.length != 0) input._impl->bufferAccumulator.push(delivery.contents.buffer);
+    }
+    flushedDeliveries.clear();
+}
+
+/***********************************************************************
+ * publish metrics
+ **********************************************************************/
+void Pothos::WorkerActor::publishMetrics(void)
+{
+    const auto relaxed = std::memory_order_relaxed;
+    auto &m = *this->metrics;
+    m.active.store(active, relaxed);
+    m.numWorkCalls.store(workStats.numWorkCalls, relaxed);
+    m.totalTicksWork.store(workStats.totalTicksWork, relaxed);
+    m.totalTicksPreWork.store(workStats.totalTicksPreWork, relaxed);
+    m.totalTicksPostWork.store(workStats.totalTicksPostWork, relaxed);
+    m.bytesConsumed.store(workStats.bytesConsumed, relaxed);
+    m.bytesProduced.store(workStats.bytesProduced, relaxed);
+    m.msgsConsumed.store(workStats.msgsConsumed, relaxed);
+    m.msgsProduced.store(workStats.msgsProduced, relaxed);
+
+    unsigned long long poolHits = 0, poolMisses = 0;
+    for (const auto &entry : this->flatInputs)
+    {
+        const auto &stats = entry.impl->stats;
+        auto &pm = *entry.metrics;
+        pm.totalElements.store(entry.port->totalElements(), relaxed);
+        pm.totalMessages.store(entry.port->totalMessages(), relaxed);
+        pm.totalLabels.store(stats.totalLabels, relaxed);
+        pm.queuedElements.store(entry.impl->bufferAccumulator.getTotalBytesAvailable()/entry.elemSize, relaxed);
+        pm.queuedMessages.store(entry.impl->asyncMessages.size(), relaxed);
+        pm.queuedLabels.store(entry.impl->inlineMessages.size(), relaxed);
+        pm.droppedMessages.store(entry.impl->droppedMessages, relaxed);
+        pm.totalTicksBlocked.store(stats.totalTicksBlocked, relaxed);
+        pm.ticksBlockedSince.store(stats.ticksBlockedSince, relaxed);
+        poolHits += entry.impl->bufferAccumulator.getPoolHits();
+        poolMisses += entry.impl->bufferAccumulator.getPoolMisses();
+    }
+    m.bufferPoolHits.store(poolHits, relaxed);
+    m.bufferPoolMisses.store(poolMisses, relaxed);
+
+    for (const auto &entry : this->flatOutputs)
+    {
+        const auto &stats = entry.impl->stats;
+        auto &pm = *entry.metrics;
+        pm.totalElements.store(entry.port->totalElements(), relaxed);
+        pm.totalMessages.store(entry.port->totalMessages(), relaxed);
+        pm.totalLabels.store(stats.totalLabels, relaxed);
+        pm.totalTicksBlocked.store(stats.totalTicksBlocked, relaxed);
+        pm.ticksBlockedSince.store(stats.ticksBlockedSince, relaxed);
+        pm.buffersReady.store((entry.mgr == nullptr)?0:entry.mgr->numReady(), relaxed);
+        pm.buffersTotal.store(entry.impl->bufferManagerArgs.numBuffers, relaxed);
+    }
+}
@@ -5,13 +5,20 @@
 #include "Framework/InputPortImpl.hpp"
 #include "Framework/OutputPortImpl.hpp"
 #include "Framework/WorkerStats.hpp"
+#include "Framework/WorkerTrace.hpp"
+#include "Framework/WorkerMetrics.hpp"
 #include <Pothos/Framework/Block.hpp>
 #include <Pothos/Framework/Exception.hpp>
 #include <Theron/Actor.h>
 #include <Theron/Framework.h>
 #include <Theron/Receiver.h>
+#include <Theron/Register.h>
 #include <Poco/Format.h>
+#include <Poco/Event.h>
 #include <iostream>
+#include <atomic>
+#include <mutex>
+#include <vector>
 
 int portNameToIndex(const std::string &name);
 
@@ -34,10 +41,15 @@ PortMessage<PortIdType, MessageType> makePortMessage(const PortIdType &id, const
     return message;
 }
 
-struct BufferReturnMessage
+/***********************************************************************
+ * A stream buffer bundled with the labels posted in the same work():
+ * One port message delivers both, and the labels are queued before
+ * the buffer is accumulated, so that work() sees them together.
+ **********************************************************************/
+struct LabeledBuffer
 {
-    Pothos::BufferManager *mgr;
-    Pothos::ManagedBuffer buff;
+    Pothos::BufferChunk buffer;
+    std::vector<Pothos::Label> labels;
 };
 
 struct BumpWorkMessage
@@ -45,6 +57,64 @@ struct BumpWorkMessage
     //
 };
 
+/***********************************************************************
+ * Stream data delivered by an in-process producer:
+ * A buffer with its labels for one input port.
+ **********************************************************************/
+struct StreamDelivery
+{
+    StreamDelivery(void):
+        index(-1)
+    {}
+    int index; //input port number, or -1 for the named port
+    std::string name; //input port name, only set without an index
+    LabeledBuffer contents;
+};
+
+/***********************************************************************
+ * Coalesced wakeup state shared between the actor and other threads:
+ * Producers of work for the actor set the scheduled flag and only
+ * send a BumpWorkMessage when the flag was previously clear.
+ * Returned buffers wait in the buffer manager's return queue,
+ * and stream data from in-process producers waits in the deliveries.
+ **********************************************************************/
+struct WorkerWakeup
+{
+    WorkerWakeup(void):
+        scheduled(false)
+    {}
+    std::atomic<bool> scheduled;
+    std::mutex mutex; //protects the deliveries
+    std::vector<StreamDelivery> deliveries;
+};
+
+/***********************************************************************
+ * Sent by a block to the upstream blocks that fill its message queue:
+ * The producer does not call work() while any consumer throttles it.
+ **********************************************************************/
+struct BackpressureMessage
+{
+    bool throttle;
+};
+
+/***********************************************************************
+ * Sent by an output port after its last stream buffer:
+ * An input has ended once each of its upstream ports sent one.
+ * It shares the lane of the stream data to stay in order with it.
+ **********************************************************************/
+struct EndOfStream
+{
+    //
+};
+
+/***********************************************************************
+ * Sent when the first metrics server starts, see WorkerMetrics.hpp
+ **********************************************************************/
+struct PublishMetricsMessage
+{
+    //
+};
+
 struct ActivateWorkMessage
 {
     //
@@ -60,6 +130,15 @@ struct ShutdownActorMessage
     //
 };
 
+/***********************************************************************
+ * Echoed back to the sender in the normal lane:
+ * The reply arrives after every message queued ahead of it.
+ **********************************************************************/
+struct FlushActorMessage
+{
+    //
+};
+
 struct RequestPortInfoMessage
 {
     bool isInput;
@@ -84,6 +163,49 @@ struct OpaqueCallResultMessage
     std::shared_ptr<Pothos::Exception> error;
 };
 
+/***********************************************************************
+ * Control and introspection messages use the priority lane,
+ * so they are serviced ahead of queued stream data messages.
+ **********************************************************************/
+typedef PortMessage<std::string, PortSubscriberMessage> PortSubscriberPortMessage;
+THERON_DECLARE_PRIORITY_MESSAGE(PortSubscriberPortMessage);
+THERON_DECLARE_PRIORITY_MESSAGE(RequestPortInfoMessage);
+THERON_DECLARE_PRIORITY_MESSAGE(RequestWorkerStatsMessage);
+THERON_DECLARE_PRIORITY_MESSAGE(OpaqueCallMessage);
+THERON_DECLARE_PRIORITY_MESSAGE(BackpressureMessage);
+THERON_DECLARE_PRIORITY_MESSAGE(PublishMetricsMessage);
+
+/***********************************************************************
+ * Trace event names for the sent port message contents
+ **********************************************************************/
+inline const char *traceSendName(const Pothos::Object &){return "sendMessage";}
+inline const char *traceSendName(const Pothos::Label &){return "sendLabel";}
+inline const char *traceSendName(const Pothos::BufferChunk &){return "sendBuffer";}
+inline const char *traceSendName(const LabeledBuffer &){return "sendBuffer";}
+inline const char *traceSendName(const EndOfStream &){return "sendEndOfStream";}
+
+/***********************************************************************
+ * Flat port table entries used by the pre and post work tasks:
+ * The element size and implementation pointers are cached
+ * so the per-work bookkeeping does not walk the port maps.
+ **********************************************************************/
+struct InputPortEntry
+{
+    Pothos::InputPort *port;
+    Pothos::InputPortImpl *impl;
+    PortMetrics *metrics;
+    size_t elemSize;
+};
+
+struct OutputPortEntry
+{
+    Pothos::OutputPort *port;
+    Pothos::OutputPortImpl *impl;
+    Pothos::BufferManager *mgr;
+    PortMetrics *metrics;
+    size_t elemSize;
+};
+
 /***********************************************************************
  * Actor definition
  **********************************************************************/
@@ -93,32 +215,56 @@ public:
     WorkerActor(Block *block):
         Theron::Actor(*(block->_framework)),
         block(block),
-        active(false)
+        active(false),
+        inWork(false),
+        done(false),
+        doneEvent(false),
+        wakeup(new WorkerWakeup()),
+        traceName(block->uid()),
+        metrics(new WorkerMetrics(block->uid()))
     {
+        metrics->requestPublish = [this](void)
+        {
+            this->GetFramework().Send(PublishMetricsMessage(), Theron::Address::Null(), this->GetAddress());
+        };
+        registerWorkerMetrics(metrics);
         this->RegisterHandler(this, &WorkerActor::handleAsyncPortNameMessage);
         this->RegisterHandler(this, &WorkerActor::handleAsyncPortIndexMessage);
         this->RegisterHandler(this, &WorkerActor::handleInlinePortNameMessage);
         this->RegisterHandler(this, &WorkerActor::handleInlinePortIndexMessage);
         this->RegisterHandler(this, &WorkerActor::handleBufferPortNameMessage);
         this->RegisterHandler(this, &WorkerActor::handleBufferPortIndexMessage);
-        this->RegisterHandler(this, &WorkerActor::handleBufferReturnMessage);
+        this->RegisterHandler(this, &WorkerActor::handleLabeledBufferPortNameMessage);
+        this->RegisterHandler(this, &WorkerActor::handleLabeledBufferPortIndexMessage);
+        this->RegisterHandler(this, &WorkerActor::handleEndOfStreamPortNameMessage);
+        this->RegisterHandler(this, &WorkerActor::handleEndOfStreamPortIndexMessage);
         this->RegisterHandler(this, &WorkerActor::handleSubscriberPortIndexMessage);
         this->RegisterHandler(this, &WorkerActor::handleBumpWorkMessage);
+        this->RegisterHandler(this, &WorkerActor::handleBackpressureMessage);
+        this->RegisterHandler(this, &WorkerActor::handlePublishMetricsMessage);
         this->RegisterHandler(this, &WorkerActor::handleActivateWorkMessage);
         this->RegisterHandler(this, &WorkerActor::handleDeactivateWorkMessage);
         this->RegisterHandler(this, &WorkerActor::handleShutdownActorMessage);
+        this->RegisterHandler(this, &WorkerActor::handleFlushActorMessage);
         this->RegisterHandler(this, &WorkerActor::handleRequestPortInfoMessage);
         this->RegisterHandler(this, &WorkerActor::handleRequestWorkerStatsMessage);
         this->RegisterHandler(this, &WorkerActor::handleOpaqueCallMessage);
     }
 
+    ~WorkerActor(void)
+    {
+        //no publish requests once the actor is deregistered
+        unregisterWorkerMetrics(metrics);
+
+        //wait for a handler running on a worker thread before the members go away
+        this->Deregister();
+    }
+
     inline void bump(void)
     {
-        //only bump when we know there is nothing available in the queue
-        if (this->GetNumQueuedMessages() == 1)
-        {
-            this->GetFramework().Send(BumpWorkMessage(), this->GetAddress(), this->GetAddress());
-        }
+        //only bump when there is not already a bump in flight
+        if (wakeup->scheduled.exchange(true)) return;
+        this->GetFramework().Send(BumpWorkMessage(), this->GetAddress(), this->GetAddress());
     }
 
     ///////////////////// message handlers ///////////////////////
@@ -128,12 +274,18 @@ public:
     void handleInlinePortIndexMessage(const PortMessage<size_t, Label> &message, const Theron::Address from);
     void handleBufferPortNameMessage(const PortMessage<std::string, BufferChunk> &message, const Theron::Address from);
     void handleBufferPortIndexMessage(const PortMessage<size_t, BufferChunk> &message, const Theron::Address from);
-    void handleBufferReturnMessage(const BufferReturnMessage &message, const Theron::Address from);
+    void handleLabeledBufferPortNameMessage(const PortMessage<std::string, LabeledBuffer> &message, const Theron::Address from);
+    void handleLabeledBufferPortIndexMessage(const PortMessage<size_t, LabeledBuffer> &message, const Theron::Address from);
+    void handleEndOfStreamPortNameMessage(const PortMessage<std::string, EndOfStream> &message, const Theron::Address from);
+    void handleEndOfStreamPortIndexMessage(const PortMessage<size_t, EndOfStream> &message, const Theron::Address from);
     void handleSubscriberPortIndexMessage(const PortMessage<std::string, PortSubscriberMessage> &message, const Theron::Address from);
     void handleBumpWorkMessage(const BumpWorkMessage &message, const Theron::Address from);
+    void handleBackpressureMessage(const BackpressureMessage &message, const Theron::Address from);
+    void handlePublishMetricsMessage(const PublishMetricsMessage &message, const Theron::Address from);
     void handleActivateWorkMessage(const ActivateWorkMessage &message, const Theron::Address from);
     void handleDeactivateWorkMessage(const DeactivateWorkMessage &message, const Theron::Address from);
     void handleShutdownActorMessage(const ShutdownActorMessage &message, const Theron::Address from);
+    void handleFlushActorMessage(const FlushActorMessage &message, const Theron::Address from);
     void handleRequestPortInfoMessage(const RequestPortInfoMessage &message, const Theron::Address from);
     void handleRequestWorkerStatsMessage(const RequestWorkerStatsMessage &message, const Theron::Address from);
     void handleOpaqueCallMessage(const OpaqueCallMessage &message, const Theron::Address from);
@@ -143,13 +295,115 @@ public:
     inline void sendPortMessage(const PortSubscribersType &subs, const MessageType &contents) const
     {
         assert(this != nullptr);
+        traceInstant(traceName, traceSendName(contents));
         for (const auto &s : subs)
         {
-            if (s.index != -1) this->GetFramework().Send(makePortMessage(size_t(s.index), contents), this->GetAddress(), s.address);
-            else               this->GetFramework().Send(makePortMessage(s.name         , contents), this->GetAddress(), s.address);
+            if (s.fusedActor != nullptr)
+            {
+                if (s.index != -1) s.fusedActor->handleFusedPortMessage(makePortMessage(size_t(s.index), contents), this->GetAddress());
+                else               s.fusedActor->handleFusedPortMessage(makePortMessage(s.name         , contents), this->GetAddress());
+            }
+            else if (s.localActor != nullptr and this->postStreamDelivery(s, contents)) continue;
+            else if (s.index != -1) this->GetFramework().Send(makePortMessage(size_t(s.index), contents), this->GetAddress(), s.address);
+            else                    this->GetFramework().Send(makePortMessage(s.name         , contents), this->GetAddress(), s.address);
         }
     }
 
+    /*!
+     * Send a stream buffer with the labels posted since the last one.
+     * An empty buffer sends the labels on their own.
+     */
+    inline void sendStreamBuffer(OutputPortImpl &impl, const BufferChunk &buffer)
+    {
+        if (impl.postedLabels.empty()) return this->sendPortMessage(impl.subscribers, buffer);
+        LabeledBuffer labeledBuffer;
+        labeledBuffer.buffer = buffer;
+        labeledBuffer.labels.swap(impl.postedLabels);
+        this->sendPortMessage(impl.subscribers, labeledBuffer);
+    }
+
+    ///////////////////// in-process stream delivery ///////////////////////
+    /*!
+     * Post stream data into the deliveries of an in-process subscriber.
+     * The subscriber is bumped only when it was not already scheduled,
+     * so a stream of buffers costs at most one message per work() call.
+     * Async messages keep their port messages for the backpressure,
+     * and the end-of-stream follows them through the actor's queue.
+     * \return true when the contents were delivered
+     */
+    inline bool postStreamDelivery(const PortSubscriber &, const Object &) const
+    {
+        return false;
+    }
+
+    inline bool postStreamDelivery(const PortSubscriber &s, const Label &label) const
+    {
+        StreamDelivery delivery;
+        delivery.contents.labels.push_back(label);
+        return this->postStreamDelivery(s, delivery);
+    }
+
+    inline bool postStreamDelivery(const PortSubscriber &s, const BufferChunk &buffer) const
+    {
+        StreamDelivery delivery;
+        delivery.contents.buffer = buffer;
+        return this->postStreamDelivery(s, delivery);
+    }
+
+    inline bool postStreamDelivery(const PortSubscriber &s, const LabeledBuffer &contents) const
+    {
+        StreamDelivery delivery;
+        delivery.contents = contents;
+        return this->postStreamDelivery(s, delivery);
+    }
+
+    inline bool postStreamDelivery(const PortSubscriber &, const EndOfStream &) const
+    {
+        return false;
+    }
+
+    bool postStreamDelivery(const PortSubscriber &s, StreamDelivery &delivery) const;
+
+    //move the deliveries into the input ports, called before work()
+    void flushStreamDeliveries(void);
+    std::vector<StreamDelivery> flushedDeliveries; //reused storage for the flush
+
+    ///////////////////// fused port messages ///////////////////////
+    /*!
+     * Handle a port message from an upstream block of a fused chain.
+     * The chain shares one thread, so the message is handled directly
+     * on the caller's stack, which runs work() on cache-hot buffers.
+     * The work repeats while it makes progress, in place of the bump
+     * that only follows work triggered from the actor's own queue.
+     */
+    template <typename PortIdType, typename MessageType>
+    void handleFusedPortMessage(const PortMessage<PortIdType, MessageType> &message, const Theron::Address from)
+    {
+        auto progress = this->workProgress();
+        this->handlePortMessage(message, from);
+        while (progress != this->workProgress())
+        {
+            progress = this->workProgress();
+            this->notify();
+        }
+    }
+
+    inline unsigned long long workProgress(void) const
+    {
+        return workStats.bytesConsumed + workStats.bytesProduced + workStats.msgsConsumed + workStats.msgsProduced;
+    }
+
+    void handlePortMessage(const PortMessage<std::string, Object> &m, const Theron::Address from){this->handleAsyncPortNameMessage(m, from);}
+    void handlePortMessage(const PortMessage<size_t, Object> &m, const Theron::Address from){this->handleAsyncPortIndexMessage(m, from);}
+    void handlePortMessage(const PortMessage<std::string, Label> &m, const Theron::Address from){this->handleInlinePortNameMessage(m, from);}
+    void handlePortMessage(const PortMessage<size_t, Label> &m, const Theron::Address from){this->handleInlinePortIndexMessage(m, from);}
+    void handlePortMessage(const PortMessage<std::string, BufferChunk> &m, const Theron::Address from){this->handleBufferPortNameMessage(m, from);}
+    void handlePortMessage(const PortMessage<size_t, BufferChunk> &m, const Theron::Address from){this->handleBufferPortIndexMessage(m, from);}
+    void handlePortMessage(const PortMessage<std::string, LabeledBuffer> &m, const Theron::Address from){this->handleLabeledBufferPortNameMessage(m, from);}
+    void handlePortMessage(const PortMessage<size_t, LabeledBuffer> &m, const Theron::Address from){this->handleLabeledBufferPortIndexMessage(m, from);}
+    void handlePortMessage(const PortMessage<std::string, EndOfStream> &m, const Theron::Address from){this->handleEndOfStreamPortNameMessage(m, from);}
+    void handlePortMessage(const PortMessage<size_t, EndOfStream> &m, const Theron::Address from){this->handleEndOfStreamPortIndexMessage(m, from);}
+
     ///////////////////// port and state storage ///////////////////////
     Block *block;
     WorkInfo workInfo;
@@ -162,14 +416,43 @@ public:
     std::map<std::string, OutputPort*> namedOutputs;
     std::map<std::string, std::unique_ptr<InputPort>> inputs;
     std::map<std::string, std::unique_ptr<OutputPort>> outputs;
+    std::vector<InputPortEntry> flatInputs;
+    std::vector<OutputPortEntry> flatOutputs;
     std::map<std::string, Callable> calls;
     bool active;
+    bool inWork; //labels are bundled with the buffers of this work() call
+    bool done; //the stream ended, work() is no longer called
+    Poco::Event doneEvent; //set while done, waited on by other threads
+    std::vector<Theron::Address> throttlingConsumers; //one entry per throttle from a consumer
+    std::shared_ptr<WorkerWakeup> wakeup;
+    TraceName traceName;
+    std::shared_ptr<WorkerMetrics> metrics;
+
+    ///////////////////// message queue limits ///////////////////////
+    bool acceptAsyncMessage(InputPortImpl &impl, const Theron::Address &from);
+    void releaseProducers(InputPortImpl &impl);
+    void releaseConsumer(const Theron::Address &consumer);
+
+    ///////////////////// end of stream ///////////////////////
+    void sendEndOfStream(OutputPortImpl &impl);
+    void updateEndOfStream(const bool idleAtEnd);
 
     ///////////////////// port setup methods ///////////////////////
     void allocateInput(const std::string &name, const DType &dtype);
     void allocateOutput(const std::string &name, const DType &dtype);
     template <typename ImplType, typename PortsType>
     void __allocatePort(PortsType &ports, const std::string &name, const DType &dtype);
+    void setupBufferManager(OutputPort &port);
+    void setupBufferManagers(void);
+    void changeBufferManager(OutputPort &port, const std::string &name, const BufferManagerArgs &args);
+    size_t getInputReserveBytes(const std::string &name);
+    void negotiateBufferManager(const std::string &name, const size_t reserveBytes);
+    void setupBufferReturnCallbacks(void);
+    void setupPortTables(void);
+
+    ///////////////////// thread pool migration ///////////////////////
+    bool hasSubscribers(void) const;
+    void moveState(WorkerActor &other);
 
     ///////////////////// convenience getters ///////////////////////
     OutputPort &getOutput(const std::string &name, const char *fcn);
@@ -181,20 +464,27 @@ public:
     WorkerStats workStats;
     inline void notify(void)
     {
-        //only call when we handle the only message in the actor's queue
-        if (not active or this->GetNumQueuedMessages() > 1) return;
+        if (not active or done) return;
 
         //prework
         {
             TicksAccumulator preWorkTime(workStats.totalTicksPreWork);
-            if (not this->preWorkTasks()) return;
+            TraceSpan preWorkTrace(traceName, "preWork");
+            if (not this->preWorkTasks())
+            {
+                if (isMetricsEnabled()) this->publishMetrics();
+                return;
+            }
         }
 
         //work
+        const auto progress = this->workProgress();
+        inWork = true;
         try
         {
             workStats.numWorkCalls++;
-            TicksAccumulator preWorkTime(workStats.totalTicksWork);
+            WorkTicksAccumulator workTime(workStats);
+            TraceSpan workTrace(traceName, "work");
             block->work();
         }
         catch (const Pothos::Exception &ex)
@@ -216,14 +506,21 @@ public:
 
         //postwork
         {
-            TicksAccumulator preWorkTime(workStats.totalTicksPostWork);
+            TicksAccumulator postWorkTime(workStats.totalTicksPostWork);
+            TraceSpan postWorkTrace(traceName, "postWork");
             this->postWorkTasks();
         }
+        inWork = false;
+
+        //the block is done after a work() call at the end made no progress
+        this->updateEndOfStream(progress == this->workProgress());
 
         workStats.ticksLastWork = Theron::Detail::Clock::GetTicks();
+        if (isMetricsEnabled()) this->publishMetrics();
     }
     bool preWorkTasks(void);
     void postWorkTasks(void);
+    void publishMetrics(void);
 };
 
 /***********************************************************************
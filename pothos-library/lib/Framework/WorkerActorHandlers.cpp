@@ -3,59 +3,161 @@
 
 #include "Framework/WorkerActor.hpp"
 #include <Poco/Format.h>
-#include <algorithm> //sort
+#include <algorithm> //find, remove
 #include <cassert>
 
-void Pothos::WorkerActor::handleAsyncPortNameMessage(const PortMessage<std::string, Object> &message, const Theron::Address)
+/***********************************************************************
+ * Enforce the message depth of an input port:
+ * Drop the message, or throttle the producer when the queue is full.
+ * Each producer is throttled once until the queue drains to half,
+ * and only while it subscribes to the port, since an unsubscribed
+ * producer would never receive the release.
+ **********************************************************************/
+bool Pothos::WorkerActor::acceptAsyncMessage(InputPortImpl &impl, const Theron::Address &from)
 {
+    if (impl.messageDepth == 0 or impl.asyncMessages.size() < impl.messageDepth) return true;
+    if (impl.dropMessages)
+    {
+        impl.droppedMessages++;
+        return false;
+    }
+    auto &producers = impl.throttledProducers;
+    const auto isSubscribed = [&impl, &from](void)
+    {
+        for (const auto &sub : impl.subscribers) if (sub.address == from) return true;
+        return false;
+    };
+    if (from != Theron::Address::Null() and std::find(producers.begin(), producers.end(), from) == producers.end() and isSubscribed())
+    {
+        BackpressureMessage message;
+        message.throttle = true;
+        this->Send(message, from);
+        producers.push_back(from);
+    }
+    return true;
+}
+
+void Pothos::WorkerActor::releaseProducers(InputPortImpl &impl)
+{
+    BackpressureMessage message;
+    message.throttle = false;
+    for (const auto &producer : impl.throttledProducers) this->Send(message, producer);
+    impl.throttledProducers.clear();
+}
+
+void Pothos::WorkerActor::handleBackpressureMessage(const BackpressureMessage &message, const Theron::Address from)
+{
+    auto &consumers = this->throttlingConsumers;
+    if (message.throttle) consumers.push_back(from);
+    else
+    {
+        auto it = std::find(consumers.begin(), consumers.end(), from);
+        if (it != consumers.end()) consumers.erase(it);
+    }
+    if (consumers.empty()) this->notify();
+}
+
+/***********************************************************************
+ * Drop the throttles of a consumer that no longer subscribes to
+ * any output port, it will never send the matching release.
+ **********************************************************************/
+void Pothos::WorkerActor::releaseConsumer(const Theron::Address &consumer)
+{
+    for (const auto &entry : this->flatOutputs)
+    {
+        for (const auto &sub : entry.impl->subscribers)
+        {
+            if (sub.address == consumer) return;
+        }
+    }
+    auto &consumers = this->throttlingConsumers;
+    consumers.erase(std::remove(consumers.begin(), consumers.end(), consumer), consumers.end());
+}
+
+void Pothos::WorkerActor::handleAsyncPortNameMessage(const PortMessage<std::string, Object> &message, const Theron::Address from)
+{
+    traceInstant(traceName, "recvMessage");
     auto &input = getInput(message.id, __FUNCTION__);
+    if (not this->acceptAsyncMessage(*input._impl, from)) return;
     if (input._impl->asyncMessages.full()) input._impl->asyncMessages.set_capacity(input._impl->asyncMessages.capacity()*2);
     input._impl->asyncMessages.push_back(message.contents);
-    this->notify();
+    this->bump();
 }
 
-void Pothos::WorkerActor::handleAsyncPortIndexMessage(const PortMessage<size_t, Object> &message, const Theron::Address)
+void Pothos::WorkerActor::handleAsyncPortIndexMessage(const PortMessage<size_t, Object> &message, const Theron::Address from)
 {
+    traceInstant(traceName, "recvMessage");
     auto &input = getInput(message.id, __FUNCTION__);
+    if (not this->acceptAsyncMessage(*input._impl, from)) return;
     if (input._impl->asyncMessages.full()) input._impl->asyncMessages.set_capacity(input._impl->asyncMessages.capacity()*2);
     input._impl->asyncMessages.push_back(message.contents);
-    this->notify();
+    this->bump();
 }
 
 void Pothos::WorkerActor::handleInlinePortNameMessage(const PortMessage<std::string, Label> &message, const Theron::Address)
 {
+    traceInstant(traceName, "recvLabel");
     auto &input = getInput(message.id, __FUNCTION__);
-    input._impl->inlineMessages.push_back(message.contents);
-    std::sort(input._impl->inlineMessages.begin(), input._impl->inlineMessages.end());
+    input._impl->inlineMessages.push(message.contents);
     this->bump();
 }
 
 void Pothos::WorkerActor::handleInlinePortIndexMessage(const PortMessage<size_t, Label> &message, const Theron::Address)
 {
+    traceInstant(traceName, "recvLabel");
     auto &input = getInput(message.id, __FUNCTION__);
-    input._impl->inlineMessages.push_back(message.contents);
-    std::sort(input._impl->inlineMessages.begin(), input._impl->inlineMessages.end());
+    input._impl->inlineMessages.push(message.contents);
     this->bump();
 }
 
 void Pothos::WorkerActor::handleBufferPortNameMessage(const PortMessage<std::string, BufferChunk> &message, const Theron::Address)
 {
+    traceInstant(traceName, "recvBuffer");
     auto &input = getInput(message.id, __FUNCTION__);
     input._impl->bufferAccumulator.push(message.contents);
-    this->notify();
+    this->bump();
 }
 
 void Pothos::WorkerActor::handleBufferPortIndexMessage(const PortMessage<size_t, BufferChunk> &message, const Theron::Address)
 {
+    traceInstant(traceName, "recvBuffer");
     auto &input = getInput(message.id, __FUNCTION__);
     input._impl->bufferAccumulator.push(message.contents);
-    this->notify();
+    this->bump();
 }
 
-void Pothos::WorkerActor::handleBufferReturnMessage(const BufferReturnMessage &message, const Theron::Address)
+void Pothos::WorkerActor::handleLabeledBufferPortNameMessage(const PortMessage<std::string, LabeledBuffer> &message, const Theron::Address)
 {
-    message.mgr->push(message.buff);
-    this->notify();
+    traceInstant(traceName, "recvBuffer");
+    auto &input = getInput(message.id, __FUNCTION__);
+    for (const auto &label : message.contents.labels) input._impl->inlineMessages.push(label);
+    if (message.contents.buffer.length != 0) input._impl->bufferAccumulator.push(message.contents.buffer);
+    this->bump();
+}
+
+void Pothos::WorkerActor::handleLabeledBufferPortIndexMessage(const PortMessage<size_t, LabeledBuffer> &message, const Theron::Address)
+{
+    traceInstant(traceName, "recvBuffer");
+    auto &input = getInput(message.id, __FUNCTION__);
+    for (const auto &label : message.contents.labels) input._impl->inlineMessages.push(label);
+    if (message.contents.buffer.length != 0) input._impl->bufferAccumulator.push(message.contents.buffer);
+    this->bump();
+}
+
+void Pothos::WorkerActor::handleEndOfStreamPortNameMessage(const PortMessage<std::string, EndOfStream> &message, const Theron::Address)
+{
+    traceInstant(traceName, "recvEndOfStream");
+    auto &input = getInput(message.id, __FUNCTION__);
+    input._impl->numEndOfStream++;
+    this->bump();
+}
+
+void Pothos::WorkerActor::handleEndOfStreamPortIndexMessage(const PortMessage<size_t, EndOfStream> &message, const Theron::Address)
+{
+    traceInstant(traceName, "recvEndOfStream");
+    auto &input = getInput(message.id, __FUNCTION__);
+    input._impl->numEndOfStream++;
+    this->bump();
 }
 
 void Pothos::WorkerActor::handleSubscriberPortIndexMessage(const PortMessage<std::string, PortSubscriberMessage> &message, const Theron::Address from)
@@ -118,6 +220,17 @@ void Pothos::WorkerActor::handleSubscriberPortIndexMessage(const PortMessage<std
             auto it = std::find(port._impl->subscribers.begin(), port._impl->subscribers.end(), sub);
             if (it == port._impl->subscribers.end()) throw Poco::format("input %s subscription missing from output port %s", sub.name, message.id);
             port._impl->subscribers.erase(it);
+            this->releaseConsumer(sub.address);
+        }
+
+        //subscriber is an input of the same fused chain, deliver by direct call
+        if (message.contents.action == "FUSEINPUT")
+        {
+            auto &port = getOutput(message.id, __FUNCTION__);
+            const auto &sub = message.contents.port;
+            auto it = std::find(port._impl->subscribers.begin(), port._impl->subscribers.end(), sub);
+            if (it == port._impl->subscribers.end()) throw Poco::format("input %s subscription missing from output port %s", sub.name, message.id);
+            it->fusedActor = sub.fusedActor;
         }
 
         //unsubscriber is an output, remove from the inputs subscribers list
@@ -128,6 +241,17 @@ void Pothos::WorkerActor::handleSubscriberPortIndexMessage(const PortMessage<std
             auto it = std::find(port._impl->subscribers.begin(), port._impl->subscribers.end(), sub);
             if (it == port._impl->subscribers.end()) throw Poco::format("output %s subscription missing from input port %s", sub.name, message.id);
             port._impl->subscribers.erase(it);
+
+            //a removed producer must not stay throttled by this port
+            auto &producers = port._impl->throttledProducers;
+            auto producer = std::find(producers.begin(), producers.end(), sub.address);
+            if (producer != producers.end())
+            {
+                BackpressureMessage release;
+                release.throttle = false;
+                this->Send(release, sub.address);
+                producers.erase(producer);
+            }
         }
 
         if (from != Theron::Address::Null()) this->Send(std::string(""), from);
@@ -143,8 +267,17 @@ void Pothos::WorkerActor::handleSubscriberPortIndexMessage(const PortMessage<std
     this->bump();
 }
 
+void Pothos::WorkerActor::handlePublishMetricsMessage(const PublishMetricsMessage &, const Theron::Address)
+{
+    this->publishMetrics();
+    this->bump();
+}
+
 void Pothos::WorkerActor::handleBumpWorkMessage(const BumpWorkMessage &, const Theron::Address)
 {
+    //clear the flag before the work so that a buffer returned or delivered
+    //after the flush will schedule another bump work message
+    wakeup->scheduled = false;
     this->notify();
 }
 
@@ -154,6 +287,14 @@ void Pothos::WorkerActor::handleActivateWorkMessage(const ActivateWorkMessage &,
     {
         this->block->activate();
         this->active = true;
+        this->metrics->active = true;
+        this->workStats.ticksActivated = Theron::Detail::Clock::GetTicks();
+        //send the end-of-stream that was posted before activation
+        for (auto &entry : this->flatOutputs)
+        {
+            if (entry.impl->endOfStream) this->sendEndOfStream(*entry.impl);
+        }
+        this->updateEndOfStream(false);
         this->Send(std::string(""), from);
     }
     catch (const Pothos::Exception &ex)
@@ -180,7 +321,19 @@ void Pothos::WorkerActor::handleDeactivateWorkMessage(const DeactivateWorkMessag
     try
     {
         this->active = false;
+        this->metrics->active = false;
+        for (auto &entry : this->flatInputs) this->releaseProducers(*entry.impl);
         this->block->deactivate();
+
+        //a later activation starts a new stream
+        this->done = false;
+        this->doneEvent.reset();
+        for (auto &entry : this->flatInputs) entry.impl->numEndOfStream = 0;
+        for (auto &entry : this->flatOutputs)
+        {
+            entry.impl->endOfStream = false;
+            entry.impl->endOfStreamSent = false;
+        }
         this->Send(std::string(""), from);
     }
     catch (const Pothos::Exception &ex)
@@ -209,10 +362,17 @@ void Pothos::WorkerActor::handleShutdownActorMessage(const ShutdownActorMessage
     indexedInputs.clear();
     namedOutputs.clear();
     namedInputs.clear();
+    flatOutputs.clear();
+    flatInputs.clear();
 
     if (from != Theron::Address::Null()) this->Send(message, from);
 }
 
+void Pothos::WorkerActor::handleFlushActorMessage(const FlushActorMessage &message, const Theron::Address from)
+{
+    if (from != Theron::Address::Null()) this->Send(message, from);
+}
+
 void Pothos::WorkerActor::handleRequestPortInfoMessage(const RequestPortInfoMessage &message, const Theron::Address from)
 {
     //empty name is all ports
@@ -235,6 +395,44 @@ void Pothos::WorkerActor::handleRequestPortInfoMessage(const RequestPortInfoMess
 void Pothos::WorkerActor::handleRequestWorkerStatsMessage(const RequestWorkerStatsMessage &, const Theron::Address from)
 {
     this->workStats.ticksStatsQuery = Theron::Detail::Clock::GetTicks();
+
+    //the reserve copy pools are counted by the input accumulators
+    this->workStats.bufferPoolHits = 0;
+    this->workStats.bufferPoolMisses = 0;
+    for (const auto &entry : this->flatInputs)
+    {
+        this->workStats.bufferPoolHits += entry.impl->bufferAccumulator.getPoolHits();
+        this->workStats.bufferPoolMisses += entry.impl->bufferAccumulator.getPoolMisses();
+    }
+
+    //snapshot the port stats, an ongoing blocked interval counts up to now
+    const auto now = this->workStats.ticksStatsQuery;
+    const auto snapshot = [now](const PortStats &stats)
+    {
+        PortStats result = stats;
+        if (result.ticksBlockedSince != 0) result.totalTicksBlocked += now - result.ticksBlockedSince;
+        return result;
+    };
+    this->workStats.inputStats.clear();
+    for (const auto &entry : this->flatInputs)
+    {
+        auto stats = snapshot(entry.impl->stats);
+        stats.totalElements = entry.port->totalElements();
+        stats.totalMessages = entry.port->totalMessages();
+        stats.queuedElements = entry.impl->bufferAccumulator.getTotalBytesAvailable()/entry.elemSize;
+        stats.queuedMessages = entry.impl->asyncMessages.size();
+        stats.queuedLabels = entry.impl->inlineMessages.size();
+        this->workStats.inputStats[entry.port->name()] = stats;
+    }
+    this->workStats.outputStats.clear();
+    for (const auto &entry : this->flatOutputs)
+    {
+        auto stats = snapshot(entry.impl->stats);
+        stats.totalElements = entry.port->totalElements();
+        stats.totalMessages = entry.port->totalMessages();
+        this->workStats.outputStats[entry.port->name()] = stats;
+    }
+
     this->Send(this->workStats, from);
     this->bump();
 }
@@ -63,6 +63,25 @@ struct WorkerActorInterface
         actor->GetFramework().Send(makePortMessage(myPortName, message), receiver->GetAddress(), actor->GetAddress());
     }
 
+    void sendLocalPortSubscriberMessage(
+        const std::string &action,
+        const std::string &myPortName,
+        const std::string &subscriberPortName,
+        const WorkerActorInterface &subscriber
+    )
+    {
+        receiver.reset(new InfoReceiver<std::string>());
+
+        //the subscriber is in this process, stream data is delivered to it directly
+        PortSubscriberMessage message;
+        message.action = action;
+        message.port.name = subscriberPortName;
+        message.port.address = subscriber.getAddress();
+        message.port.localActor = subscriber.actor.get();
+
+        actor->GetFramework().Send(makePortMessage(myPortName, message), receiver->GetAddress(), actor->GetAddress());
+    }
+
     std::string waitStringResult(void)
     {
         assert(receiver);
@@ -81,6 +100,49 @@ struct WorkerActorInterface
         return receiver.WaitInfo().dtype();
     }
 
+    bool hasDefaultThreadPool(void) const
+    {
+        return actor->block->getThreadPool() == Pothos::ThreadPool::getDefault();
+    }
+
+    void setThreadPool(const Pothos::ThreadPool &threadPool)
+    {
+        actor->block->setThreadPool(threadPool);
+    }
+
+    void setOutputBufferManager(const std::string &portName, const std::string &name, const Pothos::BufferManagerArgs &args)
+    {
+        actor->getOutput(portName, "Pothos::Topology::setBufferManager()").setBufferManager(name, args);
+    }
+
+    size_t getInputReserveBytes(const std::string &portName)
+    {
+        return actor->getInputReserveBytes(portName);
+    }
+
+    void negotiateBufferManager(const std::string &portName, const size_t reserveBytes)
+    {
+        actor->negotiateBufferManager(portName, reserveBytes);
+    }
+
+    void sendFusePortSubscriberMessage(
+        const std::string &myPortName,
+        const std::string &subscriberPortName,
+        const WorkerActorInterface &subscriber
+    )
+    {
+        receiver.reset(new InfoReceiver<std::string>());
+
+        //the actor marks the subscription on its own thread, after any messages in flight
+        PortSubscriberMessage message;
+        message.action = "FUSEINPUT";
+        message.port.name = subscriberPortName;
+        message.port.address = subscriber.getAddress();
+        message.port.fusedActor = subscriber.actor.get();
+
+        actor->GetFramework().Send(makePortMessage(myPortName, message), receiver->GetAddress(), actor->GetAddress());
+    }
+
     WorkerStats getWorkerStats(void)
     {
         InfoReceiver<WorkerStats> receiver;
@@ -88,8 +150,26 @@ struct WorkerActorInterface
         return receiver.WaitInfo();
     }
 
+    void sendStatsRequest(void)
+    {
+        statsReceiver.reset(new InfoReceiver<WorkerStats>());
+        actor->GetFramework().Send(RequestWorkerStatsMessage(), statsReceiver->GetAddress(), actor->GetAddress());
+    }
+
+    WorkerStats waitStatsResult(void)
+    {
+        assert(statsReceiver);
+        return statsReceiver->WaitInfo();
+    }
+
+    bool waitDone(const long timeoutMs)
+    {
+        return actor->doneEvent.tryWait(timeoutMs);
+    }
+
     std::shared_ptr<Pothos::WorkerActor> actor;
     std::shared_ptr<InfoReceiver<std::string>> receiver;
+    std::shared_ptr<InfoReceiver<WorkerStats>> statsReceiver;
 };
 
 #include <Pothos/Managed.hpp>
@@ -101,7 +181,17 @@ static auto managedWorkerActorInterface = Pothos::ManagedClass()
     .registerMethod(POTHOS_FCN_TUPLE(WorkerActorInterface, sendActivateMessage))
     .registerMethod(POTHOS_FCN_TUPLE(WorkerActorInterface, sendDeactivateMessage))
     .registerMethod(POTHOS_FCN_TUPLE(WorkerActorInterface, sendPortSubscriberMessage))
+    .registerMethod(POTHOS_FCN_TUPLE(WorkerActorInterface, sendLocalPortSubscriberMessage))
     .registerMethod(POTHOS_FCN_TUPLE(WorkerActorInterface, waitStringResult))
     .registerMethod(POTHOS_FCN_TUPLE(WorkerActorInterface, getPortDType))
     .registerMethod(POTHOS_FCN_TUPLE(WorkerActorInterface, getWorkerStats))
+    .registerMethod(POTHOS_FCN_TUPLE(WorkerActorInterface, sendStatsRequest))
+    .registerMethod(POTHOS_FCN_TUPLE(WorkerActorInterface, waitStatsResult))
+    .registerMethod(POTHOS_FCN_TUPLE(WorkerActorInterface, waitDone))
+    .registerMethod(POTHOS_FCN_TUPLE(WorkerActorInterface, hasDefaultThreadPool))
+    .registerMethod(POTHOS_FCN_TUPLE(WorkerActorInterface, setThreadPool))
+    .registerMethod(POTHOS_FCN_TUPLE(WorkerActorInterface, setOutputBufferManager))
+    .registerMethod(POTHOS_FCN_TUPLE(WorkerActorInterface, getInputReserveBytes))
+    .registerMethod(POTHOS_FCN_TUPLE(WorkerActorInterface, negotiateBufferManager))
+    .registerMethod(POTHOS_FCN_TUPLE(WorkerActorInterface, sendFusePortSubscriberMessage))
     .commit("Pothos/WorkerActorInterface");
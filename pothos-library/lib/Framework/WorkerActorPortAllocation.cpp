@@ -4,6 +4,7 @@
 #include "Framework/WorkerActor.hpp"
 #include <Poco/NumberParser.h>
 #include <Poco/Exception.h> //SyntaxException
+#include <algorithm> //max
 #include <cassert>
 
 /***********************************************************************
@@ -19,17 +20,16 @@ int portNameToIndex(const std::string &name)
     return -1;
 }
 
-static void bufferManagerPushExternal(
-    Pothos::BufferManager *mgr,
+static void bufferManagerWakeup(
+    std::shared_ptr<WorkerWakeup> wakeup,
     std::shared_ptr<Theron::Framework> framework,
-    const Theron::Address &addr,
-    const Pothos::ManagedBuffer &buff
+    const Theron::Address &addr
 )
 {
-    BufferReturnMessage message;
-    message.mgr = mgr;
-    message.buff = buff;
-    framework->Send(message, Theron::Address::Null(), addr);
+    //the manager already coalesced returns per starvation,
+    //the flag coalesces with other sources of bump messages
+    if (wakeup->scheduled.exchange(true)) return;
+    framework->Send(BumpWorkMessage(), Theron::Address::Null(), addr);
 }
 
 /***********************************************************************
@@ -77,6 +77,7 @@ void Pothos::WorkerActor::allocateInput(const std::string &name, const DType &dt
     setupPorts(inputs, namedInputs, indexedInputs);
     workInfo.inputPointers.resize(indexedInputs.size());
     inputPortInfo.emplace_back(name, inputs.at(name)->dtype());
+    this->setupPortTables();
 }
 
 void Pothos::WorkerActor::allocateOutput(const std::string &name, const DType &dtype)
@@ -85,13 +86,186 @@ void Pothos::WorkerActor::allocateOutput(const std::string &name, const DType &d
     setupPorts(outputs, namedOutputs, indexedOutputs);
     workInfo.outputPointers.resize(indexedOutputs.size());
     outputPortInfo.emplace_back(name, outputs.at(name)->dtype());
+    this->setupBufferManager(*outputs.at(name));
+    this->setupBufferReturnCallbacks();
+    this->setupPortTables();
+}
+
+void Pothos::WorkerActor::setupBufferManager(OutputPort &port)
+{
+    //allocate on the NUMA node that runs this block's thread pool
+    BufferManagerArgs args = port._impl->bufferManagerArgs;
+    if (args.nodeAffinity == -1) args.nodeAffinity = block->getThreadPool().getNodeAffinity();
+    port._impl->bufferManager = BufferManager::make(port._impl->bufferManagerName, args);
+}
+
+void Pothos::WorkerActor::setupBufferManagers(void)
+{
+    for (auto &entry : this->outputs)
+    {
+        this->setupBufferManager(*entry.second);
+    }
+    this->setupBufferReturnCallbacks();
+    this->setupPortTables();
+}
+
+void Pothos::WorkerActor::changeBufferManager(OutputPort &port, const std::string &name, const BufferManagerArgs &args)
+{
+    //keep the old configuration when the factory fails
+    const auto oldName = port._impl->bufferManagerName;
+    const auto oldArgs = port._impl->bufferManagerArgs;
+    port._impl->bufferManagerName = name;
+    port._impl->bufferManagerArgs = args;
+    try
+    {
+        this->setupBufferManager(port);
+    }
+    catch (const BufferManagerFactoryError &)
+    {
+        port._impl->bufferManagerName = oldName;
+        port._impl->bufferManagerArgs = oldArgs;
+        throw;
+    }
+    this->setupBufferReturnCallbacks();
+    this->setupPortTables();
+}
 
+void Pothos::WorkerActor::setupBufferReturnCallbacks(void)
+{
     //setup the buffer return callback on the manager
     for (auto &entry : this->outputs)
     {
         auto &port = *entry.second;
         auto &mgr = port._impl->bufferManager;
-        mgr->setCallback(std::bind(&bufferManagerPushExternal,
-            mgr.get(), block->_framework, this->GetAddress(), std::placeholders::_1));
+        mgr->setCallback(std::bind(&bufferManagerWakeup,
+            wakeup, block->_framework, this->GetAddress()));
+    }
+}
+
+void Pothos::WorkerActor::setupPortTables(void)
+{
+    //the published metrics follow the port tables
+    std::vector<std::shared_ptr<PortMetrics>> portMetrics;
+
+    //flatten the ports in name order, the same order as the port maps
+    flatInputs.clear();
+    for (auto &entry : this->inputs)
+    {
+        auto &port = *entry.second;
+        InputPortEntry flat;
+        flat.port = &port;
+        flat.impl = port._impl;
+        flat.elemSize = port.dtype().size();
+        portMetrics.emplace_back(new PortMetrics(port.name(), true));
+        flat.metrics = portMetrics.back().get();
+        flatInputs.push_back(flat);
+    }
+
+    flatOutputs.clear();
+    for (auto &entry : this->outputs)
+    {
+        auto &port = *entry.second;
+        OutputPortEntry flat;
+        flat.port = &port;
+        flat.impl = port._impl;
+        flat.mgr = port._impl->bufferManager.get();
+        flat.elemSize = port.dtype().size();
+        portMetrics.emplace_back(new PortMetrics(port.name(), false));
+        flat.metrics = portMetrics.back().get();
+        flatOutputs.push_back(flat);
+    }
+
+    std::lock_guard<std::mutex> lock(metrics->portsMutex);
+    metrics->ports.swap(portMetrics);
+}
+
+/***********************************************************************
+ * Move the port state from an actor in another framework
+ **********************************************************************/
+bool Pothos::WorkerActor::hasSubscribers(void) const
+{
+    for (const auto &entry : this->inputs)
+    {
+        if (not entry.second->_impl->subscribers.empty()) return true;
+    }
+    for (const auto &entry : this->outputs)
+    {
+        if (not entry.second->_impl->subscribers.empty()) return true;
+    }
+    return false;
+}
+
+void Pothos::WorkerActor::moveState(WorkerActor &other)
+{
+    assert(not other.hasSubscribers());
+
+    workInfo = other.workInfo;
+    inputPortInfo = other.inputPortInfo;
+    outputPortInfo = other.outputPortInfo;
+    inputs = std::move(other.inputs);
+    outputs = std::move(other.outputs);
+    calls = std::move(other.calls);
+    active = other.active;
+    done = other.done;
+    if (done) doneEvent.set();
+    workStats = other.workStats;
+    {
+        std::lock_guard<std::mutex> lock(other.wakeup->mutex);
+        wakeup->deliveries.swap(other.wakeup->deliveries);
+    }
+
+    other.inputs.clear();
+    other.outputs.clear();
+    setupPorts(other.inputs, other.namedInputs, other.indexedInputs);
+    setupPorts(other.outputs, other.namedOutputs, other.indexedOutputs);
+
+    //the ports now belong to this actor
+    setupPorts(inputs, namedInputs, indexedInputs);
+    setupPorts(outputs, namedOutputs, indexedOutputs);
+    for (auto &entry : this->inputs) entry.second->_impl->actor = this;
+    for (auto &entry : this->outputs) entry.second->_impl->actor = this;
+    this->setupBufferReturnCallbacks();
+    this->setupPortTables();
+    other.setupPortTables();
+
+    //the metrics of this actor replace the metrics of the other
+    unregisterWorkerMetrics(other.metrics);
+    if (isMetricsEnabled()) this->publishMetrics();
+}
+
+/***********************************************************************
+ * Negotiate output buffers for the reserve of downstream inputs
+ **********************************************************************/
+size_t Pothos::WorkerActor::getInputReserveBytes(const std::string &name)
+{
+    auto &port = this->getInput(name, "Pothos::Topology::commit()");
+    return port._reserveElements*port.dtype().size();
+}
+
+void Pothos::WorkerActor::negotiateBufferManager(const std::string &name, const size_t reserveBytes)
+{
+    auto &port = this->getOutput(name, "Pothos::Topology::commit()");
+
+    //the user's choice of manager always wins,
+    //and the manager of an active block cannot change
+    if (port._impl->bufferManagerCustom or this->active) return;
+
+    //A reserve larger than one element may straddle two buffers.
+    //The circular manager maps the buffers contiguously in memory,
+    //so that consumers read the reserve without an accumulator copy.
+    if (reserveBytes <= port.dtype().size()) return;
+
+    //cover the straddled reserve plus one buffer for the producer
+    auto args = port._impl->bufferManagerArgs;
+    const size_t reserveBuffers = (reserveBytes + args.bufferSize - 1)/args.bufferSize;
+    args.numBuffers = std::max(args.numBuffers, reserveBuffers + 2);
+    if (port._impl->bufferManagerName == "circular" and
+        port._impl->bufferManagerArgs.numBuffers >= args.numBuffers) return;
+
+    //not all systems support circular buffers, keep the current manager
+    try
+    {
+        this->changeBufferManager(port, "circular", args);
     }
+    catch (const BufferManagerFactoryError &){}
 }
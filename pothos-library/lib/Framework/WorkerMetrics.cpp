@@ -0,0 +1,103 @@
+// Copyright (c) 2014-2014 Josh Blum
+// SPDX-License-Identifier: BSL-1.0
+
+#include "Framework/WorkerMetrics.hpp"
+#include <algorithm> //find
+
+std::atomic<bool> metricsEnabledFlag(false);
+
+PortMetrics::PortMetrics(const std::string &name, const bool isInput):
+    name(name),
+    isInput(isInput),
+    totalElements(0),
+    totalMessages(0),
+    totalLabels(0),
+    queuedElements(0),
+    queuedMessages(0),
+    queuedLabels(0),
+    droppedMessages(0),
+    totalTicksBlocked(0),
+    ticksBlockedSince(0),
+    buffersReady(0),
+    buffersTotal(0)
+{
+    return;
+}
+
+WorkerMetrics::WorkerMetrics(const std::string &uid):
+    uid(uid),
+    active(false),
+    numWorkCalls(0),
+    totalTicksWork(0),
+    totalTicksPreWork(0),
+    totalTicksPostWork(0),
+    bytesConsumed(0),
+    bytesProduced(0),
+    msgsConsumed(0),
+    msgsProduced(0),
+    bufferPoolHits(0),
+    bufferPoolMisses(0)
+{
+    return;
+}
+
+/***********************************************************************
+ * Process-wide list of worker metrics
+ **********************************************************************/
+struct WorkerMetricsRegistry
+{
+    WorkerMetricsRegistry(void):
+        numServers(0)
+    {
+        return;
+    }
+
+    std::mutex mutex;
+    size_t numServers;
+    std::vector<std::shared_ptr<WorkerMetrics>> workers;
+};
+
+static WorkerMetricsRegistry &getWorkerMetricsRegistry(void)
+{
+    //never destroyed: blocks may be destroyed during static destruction
+    static WorkerMetricsRegistry *registry = new WorkerMetricsRegistry();
+    return *registry;
+}
+
+void registerWorkerMetrics(const std::shared_ptr<WorkerMetrics> &metrics)
+{
+    auto &registry = getWorkerMetricsRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    registry.workers.push_back(metrics);
+}
+
+void unregisterWorkerMetrics(const std::shared_ptr<WorkerMetrics> &metrics)
+{
+    auto &registry = getWorkerMetricsRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    auto &workers = registry.workers;
+    auto it = std::find(workers.begin(), workers.end(), metrics);
+    if (it != workers.end()) workers.erase(it);
+}
+
+void enableWorkerMetrics(const bool enable)
+{
+    auto &registry = getWorkerMetricsRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    if (enable) registry.numServers++;
+    else registry.numServers--;
+    const bool wasEnabled = metricsEnabledFlag.exchange(registry.numServers != 0);
+
+    //a worker unregisters before its actor goes away, so the request is safe under the lock
+    if (enable and not wasEnabled)
+    {
+        for (const auto &worker : registry.workers) worker->requestPublish();
+    }
+}
+
+std::vector<std::shared_ptr<WorkerMetrics>> getAllWorkerMetrics(void)
+{
+    auto &registry = getWorkerMetricsRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    return registry.workers;
+}
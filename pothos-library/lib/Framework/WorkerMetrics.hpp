@@ -0,0 +1,85 @@
+// Copyright (c) 2014-2014 Josh Blum
+// SPDX-License-Identifier: BSL-1.0
+
+#pragma once
+#include <Pothos/Config.hpp>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+#include <mutex>
+#include <functional>
+
+/***********************************************************************
+ * Worker metrics are copies of the worker stats that the actor
+ * publishes after each work() call, so that another thread can
+ * read them without messaging the actor, see MetricsServer.hpp.
+ * The values are relaxed atomics: each one is current on its own,
+ * but a reader may see the values of two different work() calls.
+ * The workers only publish while a metrics server is alive.
+ **********************************************************************/
+extern std::atomic<bool> metricsEnabledFlag;
+
+inline bool isMetricsEnabled(void)
+{
+    return metricsEnabledFlag.load(std::memory_order_relaxed);
+}
+
+struct PortMetrics
+{
+    PortMetrics(const std::string &name, const bool isInput);
+    const std::string name;
+    const bool isInput;
+    std::atomic<unsigned long long> totalElements;
+    std::atomic<unsigned long long> totalMessages;
+    std::atomic<unsigned long long> totalLabels;
+    std::atomic<unsigned long long> queuedElements;
+    std::atomic<unsigned long long> queuedMessages;
+    std::atomic<unsigned long long> queuedLabels;
+    std::atomic<unsigned long long> droppedMessages;
+    std::atomic<unsigned long long> totalTicksBlocked;
+    std::atomic<unsigned long long> ticksBlockedSince;
+    std::atomic<unsigned long long> buffersReady;
+    std::atomic<unsigned long long> buffersTotal;
+};
+
+struct WorkerMetrics
+{
+    WorkerMetrics(const std::string &uid);
+    const std::string uid;
+    std::atomic<bool> active;
+    std::atomic<unsigned long long> numWorkCalls;
+    std::atomic<unsigned long long> totalTicksWork;
+    std::atomic<unsigned long long> totalTicksPreWork;
+    std::atomic<unsigned long long> totalTicksPostWork;
+    std::atomic<unsigned long long> bytesConsumed;
+    std::atomic<unsigned long long> bytesProduced;
+    std::atomic<unsigned long long> msgsConsumed;
+    std::atomic<unsigned long long> msgsProduced;
+    std::atomic<unsigned long long> bufferPoolHits;
+    std::atomic<unsigned long long> bufferPoolMisses;
+
+    //ask the actor to publish from its own thread, set before registration
+    std::function<void(void)> requestPublish;
+
+    //the port list changes when ports are allocated
+    std::mutex portsMutex;
+    std::vector<std::shared_ptr<PortMetrics>> ports;
+};
+
+//! Add the metrics of a worker to the process-wide list
+void registerWorkerMetrics(const std::shared_ptr<WorkerMetrics> &metrics);
+
+//! Remove the metrics of a worker from the process-wide list
+void unregisterWorkerMetrics(const std::shared_ptr<WorkerMetrics> &metrics);
+
+/*!
+ * Count a metrics server that starts or stops.
+ * While any server is alive, the workers publish after each work();
+ * when the first server starts, every worker publishes once,
+ * so that the idle workers also report their current values.
+ */
+void enableWorkerMetrics(const bool enable);
+
+//! Get the metrics of all workers in this process
+std::vector<std::shared_ptr<WorkerMetrics>> getAllWorkerMetrics(void);
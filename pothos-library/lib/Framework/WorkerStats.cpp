@@ -3,7 +3,24 @@
 
 #include "Framework/WorkerStats.hpp"
 
+PortStats::PortStats(void):
+    ticksLastBuffer(0),
+    ticksLastMessage(0),
+    ticksLastLabel(0),
+    totalElements(0),
+    totalMessages(0),
+    totalLabels(0),
+    queuedElements(0),
+    queuedMessages(0),
+    queuedLabels(0),
+    totalTicksBlocked(0),
+    ticksBlockedSince(0)
+{
+    return;
+}
+
 WorkerStats::WorkerStats(void):
+    nsPerTick(1e9/Theron::Detail::Clock::GetFrequency()),
     tickRate(Theron::Detail::Clock::GetFrequency()),
     totalTicksWork(0),
     totalTicksPreWork(0),
@@ -16,7 +33,11 @@ WorkerStats::WorkerStats(void):
     ticksLastConsumed(0),
     ticksLastProduced(0),
     ticksLastWork(0),
-    ticksStatsQuery(0)
+    ticksStatsQuery(0),
+    ticksActivated(0),
+    bufferPoolHits(0),
+    bufferPoolMisses(0),
+    workHistogram(40, 0)
 {
     return;
 }
@@ -24,9 +45,26 @@ WorkerStats::WorkerStats(void):
 #include <Pothos/Object/Serialize.hpp>
 
 namespace Pothos { namespace serialization {
+template <class Archive>
+void serialize(Archive &ar, PortStats &t, const unsigned int)
+{
+    ar & t.ticksLastBuffer;
+    ar & t.ticksLastMessage;
+    ar & t.ticksLastLabel;
+    ar & t.totalElements;
+    ar & t.totalMessages;
+    ar & t.totalLabels;
+    ar & t.queuedElements;
+    ar & t.queuedMessages;
+    ar & t.queuedLabels;
+    ar & t.totalTicksBlocked;
+    ar & t.ticksBlockedSince;
+}
+
 template <class Archive>
 void serialize(Archive &ar, WorkerStats &t, const unsigned int)
 {
+    ar & t.tickRate;
     ar & t.totalTicksWork;
     ar & t.totalTicksPreWork;
     ar & t.totalTicksPostWork;
@@ -39,6 +77,12 @@ void serialize(Archive &ar, WorkerStats &t, const unsigned int)
     ar & t.ticksLastProduced;
     ar & t.ticksLastWork;
     ar & t.ticksStatsQuery;
+    ar & t.ticksActivated;
+    ar & t.bufferPoolHits;
+    ar & t.bufferPoolMisses;
+    ar & t.workHistogram;
+    ar & t.inputStats;
+    ar & t.outputStats;
 }
 }}
 
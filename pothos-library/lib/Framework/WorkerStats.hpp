@@ -4,8 +4,17 @@
 #pragma once
 #include <Pothos/Config.hpp>
 #include <Theron/Detail/Threading/Clock.h>
+#include <cmath> //frexp
+#include <string>
+#include <vector>
+#include <map>
 
-/*
+/***********************************************************************
+ * PortStats holds the counters of a single input or output port.
+ * The queue depths are only reported for input ports.
+ * The blocked time is the time that an input port was starved,
+ * or that an output port waited on a buffer or a throttled consumer.
+ **********************************************************************/
 struct PortStats
 {
     PortStats(void);
@@ -15,12 +24,47 @@ struct PortStats
     unsigned long long totalElements;
     unsigned long long totalMessages;
     unsigned long long totalLabels;
+    unsigned long long queuedElements;
+    unsigned long long queuedMessages;
+    unsigned long long queuedLabels;
+    unsigned long long totalTicksBlocked;
+    unsigned long long ticksBlockedSince; //zero when not blocked
+
+    //! Start or end a blocked interval, now is read once on demand
+    inline void updateBlocked(const bool blocked, unsigned long long &now)
+    {
+        if (blocked == (ticksBlockedSince != 0)) return;
+        if (now == 0) now = Theron::Detail::Clock::GetTicks();
+        if (blocked) ticksBlockedSince = now;
+        else
+        {
+            totalTicksBlocked += now - ticksBlockedSince;
+            ticksBlockedSince = 0;
+        }
+    }
 };
-*/
 
+/***********************************************************************
+ * WorkerStats holds the counters of a block's worker actor.
+ * Entry i>0 of the work histogram counts the work() calls that lasted
+ * between 2^(i-1) and 2^i nanoseconds, entry 0 those under a nanosecond.
+ **********************************************************************/
 struct WorkerStats
 {
     WorkerStats(void);
+
+    //! Account the duration of one work() call
+    inline void recordWork(const unsigned long long ticks)
+    {
+        totalTicksWork += ticks;
+        int exp = 0;
+        std::frexp(ticks*nsPerTick, &exp);
+        if (exp < 0) exp = 0;
+        if (size_t(exp) >= workHistogram.size()) exp = int(workHistogram.size())-1;
+        workHistogram[exp]++;
+    }
+
+    double nsPerTick;
     unsigned long long tickRate;
     unsigned long long totalTicksWork;
     unsigned long long totalTicksPreWork;
@@ -34,6 +78,12 @@ struct WorkerStats
     unsigned long long ticksLastProduced;
     unsigned long long ticksLastWork;
     unsigned long long ticksStatsQuery;
+    unsigned long long ticksActivated;
+    unsigned long long bufferPoolHits;
+    unsigned long long bufferPoolMisses;
+    std::vector<unsigned long long> workHistogram;
+    std::map<std::string, PortStats> inputStats;
+    std::map<std::string, PortStats> outputStats;
 };
 
 struct TicksAccumulator
@@ -50,3 +100,18 @@ struct TicksAccumulator
     unsigned long long &t;
     unsigned long long start;
 };
+
+struct WorkTicksAccumulator
+{
+    inline WorkTicksAccumulator(WorkerStats &s):
+        s(s), start(Theron::Detail::Clock::GetTicks())
+    {
+        return;
+    }
+    inline ~WorkTicksAccumulator(void)
+    {
+        s.recordWork(Theron::Detail::Clock::GetTicks() - start);
+    }
+    WorkerStats &s;
+    unsigned long long start;
+};
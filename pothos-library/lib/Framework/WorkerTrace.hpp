@@ -0,0 +1,79 @@
+// Copyright (c) 2014-2014 Josh Blum
+// SPDX-License-Identifier: BSL-1.0
+
+#pragma once
+#include <Pothos/Config.hpp>
+#include <Theron/Detail/Threading/Clock.h>
+#include <atomic>
+#include <string>
+
+/***********************************************************************
+ * Worker tracing records spans and instant events into the ring
+ * buffer of the calling thread, see Pothos/Framework/Trace.hpp.
+ * The event names are string literals and the block names are
+ * interned, so that an event is a few plain words to copy.
+ **********************************************************************/
+extern std::atomic<bool> traceEnabledFlag;
+
+inline bool isTraceEnabled(void)
+{
+    return traceEnabledFlag.load(std::memory_order_relaxed);
+}
+
+//! Get a name that outlives the block for the trace events
+const char *internTraceName(const std::string &name);
+
+//! Record a span from start to end ticks on this thread
+void recordTraceSpan(const char *name, const char *block, const unsigned long long start, const unsigned long long end);
+
+//! Record an instant event on this thread
+void recordTraceInstant(const char *name, const char *block);
+
+/***********************************************************************
+ * The trace name of a block, interned on the first traced event
+ **********************************************************************/
+class TraceName
+{
+public:
+    TraceName(const std::string &uid):
+        _uid(uid),
+        _name(nullptr)
+    {
+        return;
+    }
+
+    const char *get(void) const
+    {
+        if (_name == nullptr) _name = internTraceName(_uid);
+        return _name;
+    }
+
+private:
+    std::string _uid;
+    mutable const char *_name;
+};
+
+/***********************************************************************
+ * Record a span for the lifetime of this object when tracing
+ **********************************************************************/
+struct TraceSpan
+{
+    inline TraceSpan(const TraceName &block, const char *name):
+        block(block), name(name), start(isTraceEnabled()?Theron::Detail::Clock::GetTicks():0)
+    {
+        return;
+    }
+    inline ~TraceSpan(void)
+    {
+        if (start != 0) recordTraceSpan(name, block.get(), start, Theron::Detail::Clock::GetTicks());
+    }
+    const TraceName &block;
+    const char *name;
+    unsigned long long start;
+};
+
+//! Record an instant event when tracing
+inline void traceInstant(const TraceName &block, const char *name)
+{
+    if (isTraceEnabled()) recordTraceInstant(name, block.get());
+}
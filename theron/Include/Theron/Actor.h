@@ -717,6 +717,19 @@ protected:
     template <class ValueType>
     inline bool TailSend(const ValueType &value, const Address &address) const;
 
+    /**
+    \brief Deregisters the actor from its framework ahead of its destruction.
+
+    Deregistration waits for any message handler of the actor that is executing on a
+    worker thread to complete, and messages arriving afterwards go to the fallback handlers.
+    Normally this happens in the Actor destructor, which runs after the members of the derived
+    class have been destroyed. Derived actors whose handlers use their own members can call
+    this method first thing in their destructor so that the members outlive the handlers.
+
+    \note Calling this method more than once, or before the Actor destructor, is harmless.
+    */
+    void Deregister();
+
 private:
 
     // Actors are non-copyable.
@@ -743,6 +756,7 @@ private:
     Detail::HandlerCollection mMessageHandlers;         ///< The message handlers registered by this actor.
     Detail::DefaultHandlerCollection mDefaultHandlers;  ///< Default message handlers registered by this actor.
     Detail::MailboxContext *mMailboxContext;            ///< Remembers the context of the worker thread processing the actor.
+    bool mRegistered;                                   ///< Indicates whether the actor is still registered with the framework.
 
     void *mMemory;                                      ///< Pointer to memory block containing final actor type.
 };
@@ -72,18 +72,21 @@ public:
 
     /**
     Pushes a message into the mailbox.
+    High priority messages are queued separately from normal messages.
     */
     inline void Push(IMessage *const message);
 
     /**
     Peeks at the first message in the mailbox.
     The message is inspected without actually being removed from the mailbox.
+    High priority messages come first, unless a run of them has reached the limit.
     \note It's illegal to call this method when the mailbox is empty.
     */
     inline IMessage *Front() const;
 
     /**
     Pops the first message from the mailbox.
+    This is the message returned by the preceding call to Front.
     \note It's illegal to call this method when the mailbox is empty.
     */
     inline IMessage *Pop();
@@ -140,7 +143,18 @@ private:
 
     typedef Queue<IMessage> MessageQueue;
 
+    /**
+    Maximum number of high priority messages handled in a row while normal messages wait.
+    */
+    enum
+    {
+        MAX_PRIORITY_RUN = 16
+    };
+
     MessageQueue mQueue;                        ///< Queue of messages in this mailbox.
+    MessageQueue mPriorityQueue;                ///< Queue of high priority messages in this mailbox.
+    mutable bool mFrontPriority;                ///< Indicates whether Front selected the high priority queue.
+    uint32_t mPriorityRun;                      ///< Number of high priority messages handled in a row.
     String mName;                               ///< Name of this mailbox.
     Actor *mActor;                              ///< Pointer to the actor registered with this mailbox, if any.
     mutable SpinLock mSpinLock;                 ///< Thread synchronization object protecting the mailbox.
@@ -153,6 +167,9 @@ private:
 
 inline Mailbox::Mailbox() :
   mQueue(),
+  mPriorityQueue(),
+  mFrontPriority(false),
+  mPriorityRun(0),
   mName(),
   mActor(0),
   mSpinLock(),
@@ -189,26 +206,45 @@ THERON_FORCEINLINE void Mailbox::Unlock() const
 
 THERON_FORCEINLINE bool Mailbox::Empty() const
 {
-    return mQueue.Empty();
+    return mQueue.Empty() && mPriorityQueue.Empty();
 }
 
 
 THERON_FORCEINLINE void Mailbox::Push(IMessage *const message)
 {
-    mQueue.Push(message);
+    if (message->HighPriority())
+    {
+        mPriorityQueue.Push(message);
+    }
+    else
+    {
+        mQueue.Push(message);
+    }
+
     ++mMessageCount;
 }
 
 
 THERON_FORCEINLINE IMessage *Mailbox::Front() const
 {
-    return mQueue.Front();
+    // Remember which queue was selected so that Pop removes the same message,
+    // even if a high priority message arrives while the message is processed.
+    mFrontPriority = !mPriorityQueue.Empty() && (mQueue.Empty() || mPriorityRun < MAX_PRIORITY_RUN);
+    return mFrontPriority ? mPriorityQueue.Front() : mQueue.Front();
 }
 
 
 THERON_FORCEINLINE IMessage *Mailbox::Pop()
 {
     --mMessageCount;
+
+    if (mFrontPriority)
+    {
+        ++mPriorityRun;
+        return mPriorityQueue.Pop();
+    }
+
+    mPriorityRun = 0;
     return mQueue.Pop();
 }
 
@@ -72,6 +72,11 @@ public:
     */
     virtual const char *TypeName() const = 0;
 
+    /**
+    Returns true if the message type is serviced ahead of normal messages.
+    */
+    virtual bool HighPriority() const = 0;
+
     /**
     Allows the message instance to destruct its constructed value object before being freed.
     */
@@ -87,6 +87,14 @@ public:
         return MessageTraits<ValueType>::TYPE_NAME;
     }
 
+    /**
+    Returns true if the message type is serviced ahead of normal messages.
+    */
+    virtual bool HighPriority() const
+    {
+        return MessagePriorityTraits<ValueType>::HIGH_PRIORITY;
+    }
+
     /**
     Allows the message instance to destruct its constructed value object before being freed.
     */
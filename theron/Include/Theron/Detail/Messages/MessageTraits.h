@@ -74,6 +74,30 @@ template <class ValueType>
 const char *const MessageTraits<ValueType>::TYPE_NAME = 0;
 
 
+/**
+\brief Traits template that stores the scheduling priority of message types.
+
+Mailboxes hold high priority messages in a separate queue which is serviced
+ahead of the queue of normal messages, so that infrequent control messages
+don't wait behind a long backlog of data messages. The default implementation
+marks all types as normal priority.
+
+The \ref THERON_DECLARE_PRIORITY_MESSAGE macro can be used to mark message
+types as high priority.
+
+\tparam ValueType The message type for which the traits are defined.
+\see THERON_DECLARE_PRIORITY_MESSAGE
+*/
+template <class ValueType>
+struct MessagePriorityTraits
+{
+    /**
+    \brief Indicates whether messages of this type are serviced ahead of normal messages.
+    */
+    static const bool HIGH_PRIORITY = false;
+};
+
+
 } // namespace Detail
 } // namespace Theron
 
@@ -10,6 +10,7 @@
 #include <Theron/YieldStrategy.h>
 
 #include <Theron/Detail/Threading/Condition.h>
+#include <Theron/Detail/Scheduler/YieldImplementation.h>
 #include <Theron/Detail/Threading/Lock.h>
 #include <Theron/Detail/Threading/Mutex.h>
 
@@ -68,9 +69,9 @@ public:
     friend class LockType;
 
     /**
-    Constructs a monitor with the given yield strategy hint.
+    Constructs a monitor with the given yield strategy hint and backoff parameters.
     */
-    inline explicit BlockingMonitor(const YieldStrategy yieldStrategy);
+    inline explicit BlockingMonitor(const YieldStrategy yieldStrategy, const YieldBackoff &backoff);
 
     /**
     Initializes the context structure of a worker thread.
@@ -111,7 +112,7 @@ private:
 };
 
 
-inline BlockingMonitor::BlockingMonitor(const YieldStrategy /*yieldStrategy*/)
+inline BlockingMonitor::BlockingMonitor(const YieldStrategy /*yieldStrategy*/, const YieldBackoff &/*backoff*/)
 {
 }
 
@@ -13,6 +13,7 @@
 #include <Theron/Detail/Mailboxes/Mailbox.h>
 #include <Theron/Detail/Scheduler/Counting.h>
 #include <Theron/Detail/Scheduler/SchedulerHints.h>
+#include <Theron/Detail/Scheduler/YieldImplementation.h>
 #include <Theron/Detail/Threading/Atomic.h>
 #include <Theron/Detail/Threading/Clock.h>
 #include <Theron/Detail/Threading/Utils.h>
@@ -78,7 +79,7 @@ public:
     /**
     Constructor.
     */
-    inline explicit MailboxQueue(const YieldStrategy yieldStrategy);
+    inline explicit MailboxQueue(const YieldStrategy yieldStrategy, const YieldBackoff &backoff);
 
     /**
     Initializes a user-allocated context as the 'shared' context common to all threads.
@@ -158,7 +159,7 @@ private:
 
 
 template <class MonitorType>
-inline MailboxQueue<MonitorType>::MailboxQueue(const YieldStrategy yieldStrategy) : mMonitor(yieldStrategy)
+inline MailboxQueue<MonitorType>::MailboxQueue(const YieldStrategy yieldStrategy, const YieldBackoff &backoff) : mMonitor(yieldStrategy, backoff)
 {
 }
 
@@ -401,6 +402,13 @@ THERON_FORCEINLINE bool MailboxQueue<MonitorType>::PreferLocalQueue(
             return false;
         }
     }
+    else
+    {
+        // The mailbox is being rescheduled because it still has unprocessed messages.
+        // Push it to the back of the shared queue so that a continuously busy actor
+        // can't monopolize the worker thread while other mailboxes are waiting.
+        return false;
+    }
 
     return true;
 }
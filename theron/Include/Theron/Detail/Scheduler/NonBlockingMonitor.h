@@ -73,9 +73,9 @@ public:
     friend class LockType;
 
     /**
-    Constructs a monitor with the given yield strategy hint.
+    Constructs a monitor with the given yield strategy hint and backoff parameters.
     */
-    inline explicit NonBlockingMonitor(const YieldStrategy yieldStrategy);
+    inline explicit NonBlockingMonitor(const YieldStrategy yieldStrategy, const YieldBackoff &backoff);
 
     /**
     Initializes the context structure of a worker thread.
@@ -113,11 +113,14 @@ private:
     NonBlockingMonitor &operator=(const NonBlockingMonitor &other);
 
     YieldStrategy mYieldStrategy;
+    YieldBackoff mBackoff;
     mutable SpinLock mSpinLock;
 };
 
 
-inline NonBlockingMonitor::NonBlockingMonitor(const YieldStrategy yieldStrategy) : mYieldStrategy(yieldStrategy)
+inline NonBlockingMonitor::NonBlockingMonitor(const YieldStrategy yieldStrategy, const YieldBackoff &backoff) :
+  mYieldStrategy(yieldStrategy),
+  mBackoff(backoff)
 {
 }
 
@@ -126,9 +129,10 @@ inline void NonBlockingMonitor::InitializeWorkerContext(Context *const context)
 {
     switch (mYieldStrategy)
     {
-        default:                        context->mYield.SetYieldFunction(&Detail::YieldPolicy::Hybrid);     break;
-        case YIELD_STRATEGY_HYBRID:     context->mYield.SetYieldFunction(&Detail::YieldPolicy::Hybrid);     break;
-        case YIELD_STRATEGY_SPIN:       context->mYield.SetYieldFunction(&Detail::YieldPolicy::Spin);       break;
+        default:                        context->mYield.SetYieldFunction(&Detail::YieldPolicy::Hybrid, mBackoff);     break;
+        case YIELD_STRATEGY_HYBRID:     context->mYield.SetYieldFunction(&Detail::YieldPolicy::Hybrid, mBackoff);     break;
+        case YIELD_STRATEGY_SPIN:       context->mYield.SetYieldFunction(&Detail::YieldPolicy::Spin, mBackoff);       break;
+        case YIELD_STRATEGY_BACKOFF:    context->mYield.SetYieldFunction(&Detail::YieldPolicy::Backoff, mBackoff);    break;
     }
 }
 
@@ -23,6 +23,7 @@
 #include <Theron/Detail/Scheduler/SchedulerHints.h>
 #include <Theron/Detail/Scheduler/ThreadPool.h>
 #include <Theron/Detail/Scheduler/WorkerContext.h>
+#include <Theron/Detail/Scheduler/YieldImplementation.h>
 #include <Theron/Detail/Threading/Atomic.h>
 #include <Theron/Detail/Threading/Condition.h>
 #include <Theron/Detail/Threading/Mutex.h>
@@ -61,7 +62,8 @@ public:
         const uint32_t nodeMask,
         const uint32_t processorMask,
         const float threadPriority,
-        const YieldStrategy yieldStrategy);
+        const YieldStrategy yieldStrategy,
+        const YieldBackoff &backoff);
 
     /**
     Virtual destructor.
@@ -167,7 +169,8 @@ inline Scheduler<QueueType>::Scheduler(
     const uint32_t nodeMask,
     const uint32_t processorMask,
     const float threadPriority,
-    const YieldStrategy yieldStrategy) :
+    const YieldStrategy yieldStrategy,
+    const YieldBackoff &backoff) :
   mMailboxes(mailboxes),
   mFallbackHandlers(fallbackHandlers),
   mMessageAllocator(messageAllocator),
@@ -176,7 +179,7 @@ inline Scheduler<QueueType>::Scheduler(
   mProcessorMask(processorMask),
   mThreadPriority(threadPriority),
   mSharedQueueContext(),
-  mQueue(yieldStrategy),
+  mQueue(yieldStrategy, backoff),
   mManagerThread(),
   mRunning(false),
   mTargetThreadCount(0),
@@ -0,0 +1,493 @@
+// Copyright (C) by Ashton Mason. See LICENSE.txt for licensing information.
+#ifndef THERON_DETAIL_SCHEDULER_WORKSTEALINGQUEUE_H
+#define THERON_DETAIL_SCHEDULER_WORKSTEALINGQUEUE_H
+
+
+#include <Theron/Align.h>
+#include <Theron/Assert.h>
+#include <Theron/BasicTypes.h>
+#include <Theron/Defines.h>
+#include <Theron/YieldStrategy.h>
+
+#include <Theron/Detail/Containers/Queue.h>
+#include <Theron/Detail/Mailboxes/Mailbox.h>
+#include <Theron/Detail/Scheduler/Counting.h>
+#include <Theron/Detail/Scheduler/SchedulerHints.h>
+#include <Theron/Detail/Scheduler/YieldImplementation.h>
+#include <Theron/Detail/Threading/Atomic.h>
+#include <Theron/Detail/Threading/SpinLock.h>
+#include <Theron/Detail/Threading/Utils.h>
+
+
+#ifdef _MSC_VER
+#pragma warning(push)
+#pragma warning (disable:4324)  // structure was padded due to __declspec(align())
+#endif //_MSC_VER
+
+
+namespace Theron
+{
+namespace Detail
+{
+
+
+/**
+\brief Work-stealing mailbox queue implementation with per-thread work queues.
+
+Mailboxes scheduled by a worker thread are pushed to that thread's own work queue,
+which the thread services in FIFO order. Worker threads whose own queue is empty
+steal the oldest mailbox from the queues of the other worker threads, and only wait
+on the shared queue when there is no work to steal. Mailboxes scheduled from outside
+the worker threads are pushed to the shared queue. The queue has the same interface
+as \ref MailboxQueue and so can be used by the same \ref Scheduler.
+*/
+template <class MonitorType>
+class WorkStealingQueue
+{
+public:
+
+    /**
+    The item type which is queued by the queue.
+    */
+    typedef Mailbox ItemType;
+
+    /**
+    Context structure used to access the queue.
+    */
+    class ContextType
+    {
+    public:
+
+        friend class WorkStealingQueue;
+
+        inline ContextType() :
+          mRunning(false),
+          mShared(false),
+          mIndex(MAX_CONTEXTS),
+          mCount(0)
+        {
+        }
+
+    private:
+
+        template <class ValueType>
+        struct THERON_PREALIGN(THERON_CACHELINE_ALIGNMENT) Aligned
+        {
+            ValueType mValue;
+
+        } THERON_POSTALIGN(THERON_CACHELINE_ALIGNMENT);
+
+        bool mRunning;                                      ///< Used to signal the thread to terminate.
+        bool mShared;                                       ///< Indicates whether this is the 'shared' context.
+        uint32_t mIndex;                                    ///< Index of the context in the queue's list of stealable contexts.
+        Atomic::UInt32 mCount;                              ///< Number of mailboxes in the thread-specific work queue.
+        SpinLock mLock;                                     ///< Synchronizes access to the thread-specific work queue.
+        Queue<Mailbox> mWorkQueue;                          ///< Thread-specific work queue, stolen from by other threads.
+        typename MonitorType::Context mMonitorContext;      ///< Per-thread monitor primitive context.
+        Aligned<Atomic::UInt32> mCounters[MAX_COUNTERS];    ///< Array of per-context event counters.
+    };
+
+    /**
+    Constructor.
+    */
+    inline explicit WorkStealingQueue(const YieldStrategy yieldStrategy, const YieldBackoff &backoff);
+
+    /**
+    Initializes a user-allocated context as the 'shared' context common to all threads.
+    */
+    inline void InitializeSharedContext(ContextType *const context);
+
+    /**
+    Initializes a user-allocated context as the context associated with the calling thread.
+    */
+    inline void InitializeWorkerContext(ContextType *const context);
+
+    /**
+    Releases a previously initialized shared context.
+    */
+    inline void ReleaseSharedContext(ContextType *const context);
+
+    /**
+    Releases a previously initialized worker thread context.
+    */
+    inline void ReleaseWorkerContext(ContextType *const context);
+
+    /**
+    Resets to zero the given counter for the given thread context.
+    */
+    inline void ResetCounter(ContextType *const context, const uint32_t counter) const;
+
+    /**
+    Gets the value of the given counter for the given thread context.
+    */
+    inline uint32_t GetCounterValue(const ContextType *const context, const uint32_t counter) const;
+
+    /**
+    Accumulates the value of the given counter for the given thread context.
+    */
+    inline void AccumulateCounterValue(
+        const ContextType *const context,
+        const uint32_t counter,
+        uint32_t &accumulator) const;
+
+    /**
+    Returns true if a call to Pop would return no mailbox, for the given context.
+    */
+    inline bool Empty(const ContextType *const context) const;
+
+    /**
+    Returns true if the thread with the given context is still enabled.
+    */
+    inline bool Running(const ContextType *const context) const;
+
+    /**
+    Wakes any worker threads which are blocked waiting for the queue to become non-empty.
+    */
+    inline void WakeAll();
+
+    /**
+    Pushes a mailbox into the queue, scheduling it for processing.
+    */
+    inline void Push(ContextType *const context, Mailbox *mailbox, const SchedulerHints &hints);
+
+    /**
+    Pops a previously pushed mailbox from the queue for processing.
+    */
+    inline Mailbox *Pop(ContextType *const context);
+
+private:
+
+    /**
+    Maximum number of worker thread contexts which can be stolen from.
+    */
+    enum
+    {
+        MAX_CONTEXTS = 256
+    };
+
+    WorkStealingQueue(const WorkStealingQueue &other);
+    WorkStealingQueue &operator=(const WorkStealingQueue &other);
+
+    /**
+    Pops the oldest mailbox from the work queue of the given context, if any.
+    */
+    inline Mailbox *PopFrom(ContextType *const context);
+
+    /**
+    Steals a mailbox from the work queue of any context other than the given one.
+    */
+    inline Mailbox *Steal(ContextType *const context);
+
+    mutable MonitorType mMonitor;           ///< Synchronizes access to the shared queue.
+    Queue<Mailbox> mSharedWorkQueue;        ///< Work queue shared by all the threads in a scheduler.
+    Atomic::UInt32 mLocalCount;             ///< Number of mailboxes in all the thread-specific work queues.
+    Atomic::UInt32 mSleeperCount;           ///< Number of worker threads waiting on the monitor.
+    Atomic::UInt32 mContextCount;           ///< Number of registered stealable worker contexts.
+    ContextType *mContexts[MAX_CONTEXTS];   ///< Registered worker contexts that can be stolen from.
+};
+
+
+template <class MonitorType>
+inline WorkStealingQueue<MonitorType>::WorkStealingQueue(const YieldStrategy yieldStrategy, const YieldBackoff &backoff) :
+  mMonitor(yieldStrategy, backoff),
+  mSharedWorkQueue(),
+  mLocalCount(0),
+  mSleeperCount(0),
+  mContextCount(0)
+{
+    for (uint32_t index = 0; index < MAX_CONTEXTS; ++index)
+    {
+        mContexts[index] = 0;
+    }
+}
+
+
+template <class MonitorType>
+inline void WorkStealingQueue<MonitorType>::InitializeSharedContext(ContextType *const context)
+{
+    context->mShared = true;
+}
+
+
+template <class MonitorType>
+inline void WorkStealingQueue<MonitorType>::InitializeWorkerContext(ContextType *const context)
+{
+    // Only worker threads should call this method.
+    context->mShared = false;
+    context->mRunning = true;
+
+    mMonitor.InitializeWorkerContext(&context->mMonitorContext);
+
+    // Register the context so other threads can steal from it.
+    // Contexts are reused when threads are restarted so are only registered once.
+    // The context pointer is published before the count so that thieves never see a null entry.
+    if (context->mIndex == MAX_CONTEXTS)
+    {
+        typename MonitorType::LockType lock(mMonitor);
+
+        const uint32_t index(mContextCount.Load());
+        if (index < MAX_CONTEXTS)
+        {
+            context->mIndex = index;
+            mContexts[index] = context;
+            mContextCount.Store(index + 1);
+        }
+    }
+
+    // The minimum counters need to be initialized to maxint.
+    Counting::Reset(context->mCounters[COUNTER_QUEUE_LATENCY_LOCAL_MIN].mValue, COUNTER_QUEUE_LATENCY_LOCAL_MIN);
+    Counting::Reset(context->mCounters[COUNTER_QUEUE_LATENCY_SHARED_MIN].mValue, COUNTER_QUEUE_LATENCY_SHARED_MIN);
+}
+
+
+template <class MonitorType>
+inline void WorkStealingQueue<MonitorType>::ReleaseSharedContext(ContextType *const /*context*/)
+{
+}
+
+
+template <class MonitorType>
+inline void WorkStealingQueue<MonitorType>::ReleaseWorkerContext(ContextType *const context)
+{
+    typename MonitorType::LockType lock(mMonitor);
+
+    // Stop the thread and move any mailboxes left in its work queue to the shared queue.
+    // Holding the context lock ensures no further mailboxes are pushed to the work queue.
+    context->mLock.Lock();
+    context->mRunning = false;
+
+    while (!context->mWorkQueue.Empty())
+    {
+        mSharedWorkQueue.Push(context->mWorkQueue.Pop());
+        context->mCount.Decrement();
+        mLocalCount.Decrement();
+    }
+
+    context->mLock.Unlock();
+}
+
+
+template <class MonitorType>
+inline void WorkStealingQueue<MonitorType>::ResetCounter(ContextType *const context, const uint32_t counter) const
+{
+    Counting::Reset(context->mCounters[counter].mValue, counter);
+}
+
+
+template <class MonitorType>
+THERON_FORCEINLINE uint32_t WorkStealingQueue<MonitorType>::GetCounterValue(const ContextType *const context, const uint32_t counter) const
+{
+    return Counting::Get(context->mCounters[counter].mValue);
+}
+
+
+template <class MonitorType>
+THERON_FORCEINLINE void WorkStealingQueue<MonitorType>::AccumulateCounterValue(
+    const ContextType *const context,
+    const uint32_t counter,
+    uint32_t &accumulator) const
+{
+    Counting::Accumulate(context->mCounters[counter].mValue, counter, accumulator);
+}
+
+
+template <class MonitorType>
+THERON_FORCEINLINE bool WorkStealingQueue<MonitorType>::Empty(const ContextType *const context) const
+{
+    // Check the context's own work queue.
+    // If the provided context is the shared context then it doesn't have a work queue.
+    if (!context->mShared)
+    {
+        return (context->mCount.Load() == 0);
+    }
+
+    // Check the shared work queue.
+    typename MonitorType::LockType lock(mMonitor);
+    return mSharedWorkQueue.Empty();
+}
+
+
+template <class MonitorType>
+THERON_FORCEINLINE bool WorkStealingQueue<MonitorType>::Running(const ContextType *const context) const
+{
+    return context->mRunning;
+}
+
+
+template <class MonitorType>
+THERON_FORCEINLINE void WorkStealingQueue<MonitorType>::WakeAll()
+{
+    mMonitor.PulseAll();
+}
+
+
+template <class MonitorType>
+THERON_FORCEINLINE void WorkStealingQueue<MonitorType>::Push(
+    ContextType *const context,
+    Mailbox *mailbox,
+    const SchedulerHints &hints)
+{
+    // Update the maximum mailbox queue length seen by this thread.
+    Counting::Raise(context->mCounters[COUNTER_MAILBOX_QUEUE_MAX].mValue, mailbox->Count());
+
+    // Worker threads push to their own work queue, unless the context is stopped or unregistered.
+    // A mailbox rescheduled because it still has unprocessed messages goes to the shared queue,
+    // so that a continuously busy actor can't keep its worker thread from servicing the shared queue.
+    if (!context->mShared && context->mIndex != MAX_CONTEXTS && hints.mSend)
+    {
+        context->mLock.Lock();
+
+        if (context->mRunning)
+        {
+            context->mWorkQueue.Push(mailbox);
+            context->mCount.Increment();
+            mLocalCount.Increment();
+            context->mLock.Unlock();
+
+            Counting::Increment(context->mCounters[COUNTER_LOCAL_PUSHES].mValue);
+
+            // Wake a waiting thread so that it can steal the work.
+            // Waiting threads register as sleepers before checking the local count,
+            // and the local count was incremented before checking the sleepers,
+            // so either the waiting thread sees the work or we see the waiting thread.
+            // Acquiring the lock ensures the waiting thread is actually waiting before the pulse.
+            if (mSleeperCount.Load() != 0)
+            {
+                {
+                    typename MonitorType::LockType lock(mMonitor);
+                }
+
+                mMonitor.Pulse();
+            }
+
+            return;
+        }
+
+        context->mLock.Unlock();
+    }
+
+    // Push the mailbox onto the shared work queue.
+    // Because the shared queue is accessed by multiple threads we have to protect it.
+    {
+        typename MonitorType::LockType lock(mMonitor);
+        mSharedWorkQueue.Push(mailbox);
+    }
+
+    // Pulse the condition associated with the shared queue to wake a worker thread.
+    // It's okay to release the lock before calling Pulse.
+    mMonitor.Pulse();
+    Counting::Increment(context->mCounters[COUNTER_SHARED_PUSHES].mValue);
+}
+
+
+template <class MonitorType>
+THERON_FORCEINLINE Mailbox *WorkStealingQueue<MonitorType>::Pop(ContextType *const context)
+{
+    // The shared context is never used to call Pop, only to Push
+    // messages sent outside the context of a worker thread.
+    THERON_ASSERT(context->mShared == false);
+
+    // Service the calling thread's own work queue first, then try to steal.
+    Mailbox *mailbox(PopFrom(context));
+    if (mailbox == 0)
+    {
+        mailbox = Steal(context);
+    }
+
+    if (mailbox == 0)
+    {
+        // Wait on the shared queue until we pop a mailbox from it,
+        // or until there is work in another thread's queue to steal.
+        typename MonitorType::LockType lock(mMonitor);
+
+        mSleeperCount.Increment();
+        while (mSharedWorkQueue.Empty() && mLocalCount.Load() == 0 && context->mRunning == true)
+        {
+            Counting::Increment(context->mCounters[COUNTER_YIELDS].mValue);
+            mMonitor.Wait(&context->mMonitorContext, lock);
+        }
+        mSleeperCount.Decrement();
+
+        if (!mSharedWorkQueue.Empty())
+        {
+            mailbox = static_cast<Mailbox *>(mSharedWorkQueue.Pop());
+            mMonitor.ResetYield(&context->mMonitorContext);
+        }
+    }
+
+    if (mailbox)
+    {
+        Counting::Increment(context->mCounters[COUNTER_MESSAGES_PROCESSED].mValue);
+    }
+
+    return mailbox;
+}
+
+
+template <class MonitorType>
+THERON_FORCEINLINE Mailbox *WorkStealingQueue<MonitorType>::PopFrom(ContextType *const context)
+{
+    // Check the count first to avoid taking the lock of an empty queue.
+    if (context->mCount.Load() == 0)
+    {
+        return 0;
+    }
+
+    Mailbox *mailbox(0);
+
+    context->mLock.Lock();
+
+    if (!context->mWorkQueue.Empty())
+    {
+        mailbox = context->mWorkQueue.Pop();
+        context->mCount.Decrement();
+        mLocalCount.Decrement();
+    }
+
+    context->mLock.Unlock();
+
+    return mailbox;
+}
+
+
+template <class MonitorType>
+inline Mailbox *WorkStealingQueue<MonitorType>::Steal(ContextType *const context)
+{
+    if (mLocalCount.Load() == 0)
+    {
+        return 0;
+    }
+
+    // Visit the other contexts starting after the calling context,
+    // so that the threads spread their attention across the victims.
+    const uint32_t contextCount(mContextCount.Load());
+    const uint32_t start(context->mIndex == MAX_CONTEXTS ? 0 : context->mIndex + 1);
+
+    for (uint32_t offset = 0; offset < contextCount; ++offset)
+    {
+        ContextType *const victim(mContexts[(start + offset) % contextCount]);
+        if (victim == context)
+        {
+            continue;
+        }
+
+        if (Mailbox *const mailbox = PopFrom(victim))
+        {
+            return mailbox;
+        }
+    }
+
+    return 0;
+}
+
+
+} // namespace Detail
+} // namespace Theron
+
+
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif //_MSC_VER
+
+
+#endif // THERON_DETAIL_SCHEDULER_WORKSTEALINGQUEUE_H
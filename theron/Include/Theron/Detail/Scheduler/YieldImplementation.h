@@ -14,11 +14,32 @@ namespace Detail
 {
 
 
+/**
+Tuning parameters of the backoff yield policy.
+*/
+struct YieldBackoff
+{
+    inline explicit YieldBackoff(
+        const uint32_t spinCount = 20,
+        const uint32_t yieldCount = 20,
+        const uint32_t sleepMilliseconds = 1) :
+      mSpinCount(spinCount),
+      mYieldCount(yieldCount),
+      mSleepMilliseconds(sleepMilliseconds)
+    {
+    }
+
+    uint32_t mSpinCount;            ///< Number of idle iterations spent spinning on the processor.
+    uint32_t mYieldCount;           ///< Number of further idle iterations spent yielding to other threads.
+    uint32_t mSleepMilliseconds;    ///< Duration of each sleep once the spin and yield iterations are spent.
+};
+
+
 /**
 A 'yield' function which can be called to yield a waiting thread so that
 other threads also accessing a contested resource can progress.
 */
-typedef void (* YieldFunction)(const uint32_t counter);
+typedef void (* YieldFunction)(const uint32_t counter, const YieldBackoff &backoff);
 
 
 /**
@@ -30,13 +51,15 @@ public:
 
     inline explicit YieldImplementation() :
       mCounter(0),
-      mYieldFunction(0)
+      mYieldFunction(0),
+      mBackoff()
     {
     }
 
-    THERON_FORCEINLINE void SetYieldFunction(YieldFunction yieldFunction)
+    THERON_FORCEINLINE void SetYieldFunction(YieldFunction yieldFunction, const YieldBackoff &backoff)
     {
         mYieldFunction = yieldFunction;
+        mBackoff = backoff;
     }
 
     THERON_FORCEINLINE void Reset()
@@ -47,7 +70,7 @@ public:
     THERON_FORCEINLINE void Execute()
     {
         THERON_ASSERT(mYieldFunction);
-        (*mYieldFunction)(mCounter);
+        (*mYieldFunction)(mCounter, mBackoff);
         ++mCounter;
     }
 
@@ -55,6 +78,7 @@ private:
 
     uint32_t mCounter;
     YieldFunction mYieldFunction;
+    YieldBackoff mBackoff;
 };
 
 
@@ -6,6 +6,8 @@
 #include <Theron/BasicTypes.h>
 #include <Theron/Defines.h>
 
+#include <Theron/Detail/Scheduler/YieldImplementation.h>
+
 
 namespace Theron
 {
@@ -23,12 +25,18 @@ public:
     /**
     Spin, but yield to other threads after a timeout.
     */
-    static void Hybrid(const uint32_t counter);
+    static void Hybrid(const uint32_t counter, const YieldBackoff &backoff);
 
     /**
     Spin indefinitely (or busy-wait), with no yielding to other threads.
     */
-    static void Spin(const uint32_t counter);
+    static void Spin(const uint32_t counter, const YieldBackoff &backoff);
+
+    /**
+    Spin, then yield to other threads, then sleep after a longer timeout.
+    The number of spin and yield iterations and the sleep duration are given by the backoff parameters.
+    */
+    static void Backoff(const uint32_t counter, const YieldBackoff &backoff);
 
 private:
 
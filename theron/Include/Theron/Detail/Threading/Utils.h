@@ -47,6 +47,11 @@
 #error NUMA support currently requires Windows or GCC with libnuma.
 
 #endif
+#elif THERON_GCC && defined(__linux__)
+
+// Processor affinity without NUMA support uses the Linux scheduler API.
+#include <sched.h>
+
 #endif
 
 #ifdef _MSC_VER
@@ -471,6 +476,29 @@ numa_cleanup_and_done:
 
 #endif
 
+#elif THERON_GCC && defined(__linux__)
+
+    // Without NUMA support the system is treated as a single node,
+    // so the processor mask selects processors by their absolute index.
+    if ((nodeMask & 1UL) == 0)
+    {
+        return false;
+    }
+
+    cpu_set_t cpuSet;
+    CPU_ZERO(&cpuSet);
+
+    for (uint32_t cpu = 0; cpu < 32; ++cpu)
+    {
+        if ((processorMask & (1UL << cpu)) != 0)
+        {
+            CPU_SET(cpu, &cpuSet);
+        }
+    }
+
+    // A pid of zero sets the affinity of the calling thread.
+    return sched_setaffinity(0, sizeof(cpuSet), &cpuSet) == 0;
+
 #endif // THERON_NUMA
 
     return false;
@@ -193,18 +193,24 @@ public:
         \param processorMask Bitfield mask specifying the processor affinity of the created worker threads within each enabled NUMA node.
         \param yieldStrategy Enum value specifying how freely worker threads yield to other system threads.
         \param priority Relative scheduling priority of the worker threads (range -1.0 to 1.0, 0.0 means "normal").
+        \param workStealing Use per-thread work queues with work stealing instead of the shared work queue.
         */
         inline explicit Parameters(
             const uint32_t threadCount = 16,
             const uint32_t nodeMask = 0x1,
             const uint32_t processorMask = 0xFFFFFFFF,
             const YieldStrategy yieldStrategy = YIELD_STRATEGY_CONDITION,
-            const float priority = 0.0f) :
+            const float priority = 0.0f,
+            const bool workStealing = false) :
           mThreadCount(threadCount),
           mNodeMask(nodeMask),
           mProcessorMask(processorMask),
           mYieldStrategy(yieldStrategy),
-          mThreadPriority(priority)
+          mThreadPriority(priority),
+          mWorkStealing(workStealing),
+          mBackoffSpinCount(20),
+          mBackoffYieldCount(20),
+          mBackoffSleepMilliseconds(1)
         {
         }
 
@@ -213,6 +219,10 @@ public:
         uint32_t mProcessorMask;        ///< 32-bit mask specifying the subset of the processors in each NUMA processor node upon which the framework may execute.
         YieldStrategy mYieldStrategy;   ///< Member of \ref YieldStrategy specifying how worker threads yield to other system threads when no work is available.
         float mThreadPriority;          ///< Number between -1.0 and 1.0 indicating the relative scheduling priority of the worker threads.
+        bool mWorkStealing;             ///< Whether worker threads service per-thread work queues and steal work from each other.
+        uint32_t mBackoffSpinCount;     ///< Number of idle iterations that \ref YIELD_STRATEGY_BACKOFF spends spinning on the processor.
+        uint32_t mBackoffYieldCount;    ///< Number of further idle iterations that \ref YIELD_STRATEGY_BACKOFF spends yielding to other threads.
+        uint32_t mBackoffSleepMilliseconds; ///< Duration of each sleep of \ref YIELD_STRATEGY_BACKOFF once it stops yielding (0 keeps yielding).
     };
 
     /**
@@ -731,6 +741,12 @@ private:
     */
     Detail::IScheduler *CreateScheduler();
 
+    /**
+    Allocates and initializes an owned scheduler object using the given queue implementations.
+    */
+    template <class BlockingQueue, class NonBlockingQueue>
+    Detail::IScheduler *CreateScheduler();
+
     /**
     Destroys a previously created scheduler object.
     */
@@ -142,6 +142,47 @@ and \ref THERON_DEFINE_REGISTERED_MESSAGE instead.
 */
 
 
+/**
+\def THERON_DECLARE_PRIORITY_MESSAGE
+
+\brief Declaration macro for high priority message types.
+
+Marks a message type as high priority. Each mailbox services its queue of high
+priority messages ahead of its queue of normal messages, so that control messages
+sent to a busy actor are handled promptly rather than after all of the messages
+queued before them. To avoid starving the normal messages, a mailbox handles at most
+a small number of high priority messages in a row while normal messages are waiting.
+
+Messages of the same priority are handled in the order they arrived, but a high
+priority message may be handled before normal messages that arrived earlier.
+
+Like the registration macros, this macro can only be used from within the global
+namespace, with the fully scoped name of the message type.
+
+\code
+THERON_DECLARE_PRIORITY_MESSAGE(MyNamespace::StopMessage);
+\endcode
+*/
+
+
+#ifndef THERON_DECLARE_PRIORITY_MESSAGE
+
+#define THERON_DECLARE_PRIORITY_MESSAGE(MessageType)                        \
+namespace Theron                                                            \
+{                                                                           \
+namespace Detail                                                            \
+{                                                                           \
+template <>                                                                 \
+struct MessagePriorityTraits<MessageType>                                   \
+{                                                                           \
+    static const bool HIGH_PRIORITY = true;                                 \
+};                                                                          \
+}                                                                           \
+}
+
+#endif // THERON_DECLARE_PRIORITY_MESSAGE
+
+
 #ifndef THERON_REGISTER_MESSAGE
 
 #define THERON_REGISTER_MESSAGE(MessageType)                                \
@@ -62,6 +62,11 @@ in combination with processor affinity masks, like YIELD_STRATEGY_SPIN. It's adv
 YIELD_STRATEGY_SPIN is that any other threads running on the same cores are less likely to
 be starved.
 
+YIELD_STRATEGY_BACKOFF extends the hybrid approach for latency-sensitive threads that may also
+be idle for long periods. Waiting threads spin briefly, then yield to other threads, and finally
+sleep for a millisecond at a time. The threads respond quickly to work arriving soon after they
+became idle, while threads that remain idle stop consuming the available cycles.
+
 When choosing a yield strategy it pays to consider how important low-latency responses are to your
 application. In most applications latencies of a few milliseconds are not significant, and the
 default strategy is a reasonable choice.
@@ -71,6 +76,7 @@ enum YieldStrategy
     YIELD_STRATEGY_CONDITION = 0,       ///< Threads wait on condition variables when no work is available.
     YIELD_STRATEGY_HYBRID,              ///< Threads spin for a while, then yield to other threads, when no work is available.
     YIELD_STRATEGY_SPIN,                ///< Threads busy-wait, without yielding, when no work is available.
+    YIELD_STRATEGY_BACKOFF,             ///< Threads spin, then yield to other threads, then sleep, when no work is available.
 
     // Legacy section
     YIELD_STRATEGY_BLOCKING = 0,        ///< Deprecated - use YIELD_STRATEGY_CONDITION.
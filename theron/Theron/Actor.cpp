@@ -15,6 +15,7 @@ Actor::Actor(Framework &framework, const char *const name) :
   mMessageHandlers(),
   mDefaultHandlers(),
   mMailboxContext(0),
+  mRegistered(true),
   mMemory(0)
 {
     // Claim an available directory index and mailbox for this actor.
@@ -24,7 +25,17 @@ Actor::Actor(Framework &framework, const char *const name) :
 
 Actor::~Actor()
 {
-    mFramework->DeregisterActor(this);
+    Deregister();
+}
+
+
+void Actor::Deregister()
+{
+    if (mRegistered)
+    {
+        mFramework->DeregisterActor(this);
+        mRegistered = false;
+    }
 }
 
 
@@ -17,6 +17,7 @@
 #include <Theron/Detail/Scheduler/MailboxQueue.h>
 #include <Theron/Detail/Scheduler/NonBlockingMonitor.h>
 #include <Theron/Detail/Scheduler/Scheduler.h>
+#include <Theron/Detail/Scheduler/WorkStealingQueue.h>
 #include <Theron/Detail/Network/Index.h>
 #include <Theron/Detail/Network/NameGenerator.h>
 #include <Theron/Detail/Strings/String.h>
@@ -70,15 +71,33 @@ void Framework::Release()
 
 Detail::IScheduler *Framework::CreateScheduler()
 {
+    if (mParams.mWorkStealing)
+    {
+        typedef Detail::WorkStealingQueue<Detail::BlockingMonitor> BlockingQueue;
+        typedef Detail::WorkStealingQueue<Detail::NonBlockingMonitor> NonBlockingQueue;
+        return CreateScheduler<BlockingQueue, NonBlockingQueue>();
+    }
+
     typedef Detail::MailboxQueue<Detail::BlockingMonitor> BlockingQueue;
     typedef Detail::MailboxQueue<Detail::NonBlockingMonitor> NonBlockingQueue;
+    return CreateScheduler<BlockingQueue, NonBlockingQueue>();
+}
 
+
+template <class BlockingQueue, class NonBlockingQueue>
+Detail::IScheduler *Framework::CreateScheduler()
+{
     typedef Detail::Scheduler<BlockingQueue> BlockingScheduler;
     typedef Detail::Scheduler<NonBlockingQueue> NonBlockingScheduler;
 
     IAllocator *const allocator(AllocatorManager::GetCache());
     void *schedulerMemory(0);
 
+    const Detail::YieldBackoff backoff(
+        mParams.mBackoffSpinCount,
+        mParams.mBackoffYieldCount,
+        mParams.mBackoffSleepMilliseconds);
+
     if (mParams.mYieldStrategy == YIELD_STRATEGY_CONDITION)
     {
         schedulerMemory = allocator->AllocateAligned(
@@ -104,7 +123,8 @@ Detail::IScheduler *Framework::CreateScheduler()
             mParams.mNodeMask,
             mParams.mProcessorMask,
             mParams.mThreadPriority,
-            mParams.mYieldStrategy);
+            mParams.mYieldStrategy,
+            backoff);
     }
     else
     {
@@ -116,7 +136,8 @@ Detail::IScheduler *Framework::CreateScheduler()
             mParams.mNodeMask,
             mParams.mProcessorMask,
             mParams.mThreadPriority,
-            mParams.mYieldStrategy);
+            mParams.mYieldStrategy,
+            backoff);
     }
 }
 
@@ -14,7 +14,7 @@ namespace Detail
 {
 
 
-void YieldPolicy::Hybrid(const uint32_t counter)
+void YieldPolicy::Hybrid(const uint32_t counter, const YieldBackoff &/*backoff*/)
 {
     if (counter < 10)
     {
@@ -38,7 +38,7 @@ void YieldPolicy::Hybrid(const uint32_t counter)
 }
 
 
-void YieldPolicy::Spin(const uint32_t counter)
+void YieldPolicy::Spin(const uint32_t counter, const YieldBackoff &/*backoff*/)
 {
     // This 'busy-wait' implementation never yields or sleeps.
     // It does however pause to allow another thread running on the same hyperthreaded core to proceed.
@@ -70,6 +70,29 @@ void YieldPolicy::Spin(const uint32_t counter)
 }
 
 
+void YieldPolicy::Backoff(const uint32_t counter, const YieldBackoff &backoff)
+{
+    // Spin and yield like the hybrid policy at first, but once the thread
+    // has been idle for a while put it to sleep so it stops consuming cycles.
+    if (counter < backoff.mSpinCount)
+    {
+        const uint32_t pauses(counter < backoff.mSpinCount/2 ? 1 : 50);
+        for (uint32_t i = 0; i < pauses; ++i)
+        {
+            Utils::YieldToHyperthread();
+        }
+    }
+    else if (counter < backoff.mSpinCount + backoff.mYieldCount or backoff.mSleepMilliseconds == 0)
+    {
+        Utils::YieldToAnyThread();
+    }
+    else
+    {
+        Utils::SleepThread(backoff.mSleepMilliseconds);
+    }
+}
+
+
 } // namespace Detail
 } // namespace Theron
 